@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Gerador SplitMix64: estado de 64 bits, semear é só atribuir. Serve aos
+// motores que criam uma partida nova por semente e não podem pagar a
+// inicialização de um `std::mt19937_64` a cada jogo. Atende aos requisitos de
+// UniformRandomBitGenerator, então funciona com as distribuições da <random>.
+class SplitMix64 {
+public:
+    using result_type = uint64_t;
+
+    explicit SplitMix64(uint64_t semente = 0) : estado(semente) {}
+
+    void semear(uint64_t semente) { estado = semente; }
+
+    uint64_t operator()() { return misturar(estado += INCREMENTO); }
+
+    // O i-ésimo valor (a partir de 0) da sequência que começa em `semente`,
+    // sem depender dos anteriores.
+    static uint64_t na_posicao(uint64_t semente, uint64_t i) { return misturar(semente + (i + 1) * INCREMENTO); }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return std::numeric_limits<uint64_t>::max(); }
+
+private:
+    static constexpr uint64_t INCREMENTO = 0x9e3779b97f4a7c15ull;
+
+    static uint64_t misturar(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t estado;
+};
+
+// Vetores de `L` inteiros de 32 bits com as extensões de vetor do GCC. O
+// compilador gera AVX2/AVX-512 quando o código é instanciado dentro de uma
+// função compilada para esse alvo, e instruções SSE no alvo genérico.
+template <int L>
+struct VetoresLanes {
+    typedef uint32_t u32 __attribute__((vector_size(4 * L)));
+    typedef int32_t i32 __attribute__((vector_size(4 * L)));
+    typedef uint64_t u64 __attribute__((vector_size(4 * L)));  // L/2 lanes de 64 bits, mesmo registrador
+};
+
+// Parte alta de `a * b` em cada lane de 32 bits: `(uint64_t)a * b >> 32`.
+// Multiplica as lanes pares e ímpares como lanes de 64 bits para não precisar
+// de vetores com o dobro da largura.
+template <int L>
+[[gnu::always_inline]] inline typename VetoresLanes<L>::u32 mulhi32(typename VetoresLanes<L>::u32 a, uint32_t b) {
+    using u32 = typename VetoresLanes<L>::u32;
+    using u64 = typename VetoresLanes<L>::u64;
+    u64 largos;
+    __builtin_memcpy(&largos, &a, sizeof(a));
+    u64 pares = (largos & 0xffffffffull) * b;
+    u64 impares = (largos >> 32) * b;
+    u64 combinado = (pares >> 32) | (impares & 0xffffffff00000000ull);
+    u32 resultado;
+    __builtin_memcpy(&resultado, &combinado, sizeof(resultado));
+    return resultado;
+}
+
+// `L` geradores xoshiro128++ independentes, um por lane, avançando juntos.
+template <int L>
+struct Xoshiro128Lanes {
+    using u32 = typename VetoresLanes<L>::u32;
+    u32 s0, s1, s2, s3;
+
+    [[gnu::always_inline]] void semear(uint64_t semente) {
+        // Os valores do SplitMix64 são calculados pela posição, sem a cadeia
+        // de dependência de `operator()`, e o estado é montado num array e
+        // copiado de uma vez: semear fica mais barato que uma partida curta.
+        uint32_t estado[4][L];
+        for (int l = 0; l < L; ++l) {
+            uint64_t a = SplitMix64::na_posicao(semente, 2 * l), b = SplitMix64::na_posicao(semente, 2 * l + 1);
+            estado[0][l] = static_cast<uint32_t>(a) | 1u;  // estado nunca todo zero
+            estado[1][l] = static_cast<uint32_t>(a >> 32);
+            estado[2][l] = static_cast<uint32_t>(b);
+            estado[3][l] = static_cast<uint32_t>(b >> 32);
+        }
+        __builtin_memcpy(&s0, estado[0], sizeof(s0));
+        __builtin_memcpy(&s1, estado[1], sizeof(s1));
+        __builtin_memcpy(&s2, estado[2], sizeof(s2));
+        __builtin_memcpy(&s3, estado[3], sizeof(s3));
+    }
+
+    [[gnu::always_inline]] u32 proximo() {
+        u32 resultado = rotl(s0 + s3, 7) + s0;
+        u32 t = s1 << 9;
+        s2 ^= s0;
+        s3 ^= s1;
+        s1 ^= s2;
+        s0 ^= s3;
+        s2 ^= t;
+        s3 = rotl(s3, 11);
+        return resultado;
+    }
+
+    [[gnu::always_inline]] static u32 rotl(u32 x, int k) { return (x << k) | (x >> (32 - k)); }
+};
+
+// Enche `blocos` blocos de `L` valores com o gerador vetorial. Instanciada
+// dentro de funções com atributo de alvo, gera AVX-512/AVX2 sem flags de build.
+template <int L>
+[[gnu::always_inline]] inline void encher_xoshiro(Xoshiro128Lanes<L>& rng, uint32_t* saida, size_t blocos) {
+    using u32 = typename VetoresLanes<L>::u32;
+    for (size_t b = 0; b < blocos; ++b) {
+        u32 v = rng.proximo();
+        __builtin_memcpy(saida + b * L, &v, sizeof(v));
+    }
+}
+
+__attribute__((target("avx512f,avx512vl,avx512bw")))
+inline void encher_xoshiro_avx512(Xoshiro128Lanes<16>& rng, uint32_t* saida, size_t blocos) {
+    encher_xoshiro<16>(rng, saida, blocos);
+}
+
+__attribute__((target("avx2")))
+inline void encher_xoshiro_avx2(Xoshiro128Lanes<16>& rng, uint32_t* saida, size_t blocos) {
+    encher_xoshiro<16>(rng, saida, blocos);
+}
+
+inline void encher_xoshiro_generico(Xoshiro128Lanes<16>& rng, uint32_t* saida, size_t blocos) {
+    encher_xoshiro<16>(rng, saida, blocos);
+}
+
+/*
+ * Gerador em lote para os caminhos quentes: 16 xoshiro128++ em lanes de vetor
+ * enchem um buffer de inteiros de 32 bits de uma vez, e cada sorteio só lê a
+ * próxima posição. Intervalos limitados usam o método de Lemire
+ * (multiplicação de 64 bits com rejeição rara), sem viés e sem divisão no
+ * caso comum, no lugar de um `uniform_int_distribution` por chamada.
+ *
+ * Os valores dependem só da semente, não do conjunto de instruções: as três
+ * versões do kernel calculam as mesmas lanes. Não é thread-safe; cada dono
+ * (coordenador, partida, motor) tem o seu.
+ */
+class GeradorLote {
+public:
+    using result_type = uint32_t;
+    static constexpr size_t TAMANHO_BUFFER = 256;
+
+    explicit GeradorLote(uint64_t semente = 0) { semear(semente); }
+
+    void semear(uint64_t semente) {
+        rng.semear(semente);
+        posicao = preenchidos = 0;  // enche só no primeiro sorteio
+        blocos_proxima = 1;
+    }
+
+    uint32_t operator()() {
+        if (posicao == preenchidos) encher();
+        return buffer[posicao++];
+    }
+
+    // Inteiro uniforme em [0, limite), limite > 0 (Lemire, "Fast Random
+    // Integer Generation in an Interval", 2019).
+    uint32_t abaixo(uint32_t limite) {
+        uint64_t m = static_cast<uint64_t>((*this)()) * limite;
+        uint32_t baixo = static_cast<uint32_t>(m);
+        if (baixo < limite) {
+            uint32_t limiar = -limite % limite;
+            while (baixo < limiar) {
+                m = static_cast<uint64_t>((*this)()) * limite;
+                baixo = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    // Mesmo método para limites de 64 bits, com produto de 128 bits.
+    uint64_t abaixo64(uint64_t limite) {
+        if (limite <= std::numeric_limits<uint32_t>::max()) return abaixo(static_cast<uint32_t>(limite));
+        unsigned __int128 m = static_cast<unsigned __int128>(proximo64()) * limite;
+        uint64_t baixo = static_cast<uint64_t>(m);
+        if (baixo < limite) {
+            uint64_t limiar = -limite % limite;
+            while (baixo < limiar) {
+                m = static_cast<unsigned __int128>(proximo64()) * limite;
+                baixo = static_cast<uint64_t>(m);
+            }
+        }
+        return static_cast<uint64_t>(m >> 64);
+    }
+
+    uint64_t proximo64() {
+        uint64_t alto = (*this)();
+        return alto << 32 | (*this)();
+    }
+
+    // Inteiro uniforme em [minimo, maximo], com os dois extremos inclusos.
+    int entre(int minimo, int maximo) {
+        uint32_t faixa = static_cast<uint32_t>(maximo) - static_cast<uint32_t>(minimo) + 1u;
+        if (faixa == 0) return static_cast<int>((*this)());  // faixa de 2^32 valores
+        return static_cast<int>(static_cast<uint32_t>(minimo) + abaixo(faixa));
+    }
+
+    // Real uniforme em (0, 1]; nunca zero, então serve direto a `-log(u)`.
+    double unitario() { return ((*this)() + 1.0) * (1.0 / 4294967296.0); }
+
+    // Atraso exponencial de média `media` por inversão.
+    double exponencial(double media) { return -media * std::log(unitario()); }
+
+    template <typename T>
+    void embaralhar(std::vector<T>& v) {
+        for (size_t i = v.size(); i > 1; --i) {
+            std::swap(v[i - 1], v[abaixo(static_cast<uint32_t>(i))]);
+        }
+    }
+
+    static constexpr uint32_t min() { return 0; }
+    static constexpr uint32_t max() { return std::numeric_limits<uint32_t>::max(); }
+
+    // Estado completo para checkpoints: lanes do gerador, valores do buffer
+    // ainda não lidos e tamanho da próxima recarga. Restaurado, o gerador
+    // continua exatamente a mesma sequência.
+    void salvar(std::vector<uint8_t>& saida) const {
+        uint32_t restantes = static_cast<uint32_t>(preenchidos - posicao);
+        uint32_t proxima = static_cast<uint32_t>(blocos_proxima);
+        acrescentar(saida, &rng, sizeof(rng));
+        acrescentar(saida, &restantes, sizeof(restantes));
+        acrescentar(saida, buffer + posicao, restantes * sizeof(uint32_t));
+        acrescentar(saida, &proxima, sizeof(proxima));
+    }
+
+    // Lê o estado gravado por `salvar`; devolve os bytes consumidos, ou 0 se
+    // `tamanho` não bastar ou o estado for inválido.
+    size_t restaurar(const uint8_t* dados, size_t tamanho) {
+        uint32_t restantes, proxima;
+        if (tamanho < sizeof(rng) + sizeof(restantes)) return 0;
+        std::memcpy(&restantes, dados + sizeof(rng), sizeof(restantes));
+        size_t total = sizeof(rng) + sizeof(restantes) + restantes * sizeof(uint32_t) + sizeof(proxima);
+        if (restantes > TAMANHO_BUFFER || tamanho < total) return 0;
+        std::memcpy(&proxima, dados + total - sizeof(proxima), sizeof(proxima));
+        if (proxima == 0 || proxima > TAMANHO_BUFFER / 16) return 0;
+
+        std::memcpy(&rng, dados, sizeof(rng));
+        std::memcpy(buffer, dados + sizeof(rng) + sizeof(restantes), restantes * sizeof(uint32_t));
+        posicao = 0;
+        preenchidos = restantes;
+        blocos_proxima = proxima;
+        return total;
+    }
+
+private:
+    using Kernel = void (*)(Xoshiro128Lanes<16>&, uint32_t*, size_t);
+
+    // Logo após semear enche um bloco só e dobra a cada recarga: quem
+    // ressemeia a cada partida curta não paga por valores que não vai usar. A
+    // sequência é a mesma qualquer que seja o tamanho da recarga.
+    void encher() {
+        static const Kernel kernel = escolher_kernel();
+        kernel(rng, buffer, blocos_proxima);
+        preenchidos = blocos_proxima * 16;
+        posicao = 0;
+        blocos_proxima = std::min<size_t>(blocos_proxima * 2, TAMANHO_BUFFER / 16);
+    }
+
+    static void acrescentar(std::vector<uint8_t>& saida, const void* dados, size_t tamanho) {
+        const uint8_t* p = static_cast<const uint8_t*>(dados);
+        saida.insert(saida.end(), p, p + tamanho);
+    }
+
+    static Kernel escolher_kernel() {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+            __builtin_cpu_supports("avx512bw")) {
+            return encher_xoshiro_avx512;
+        }
+        if (__builtin_cpu_supports("avx2")) return encher_xoshiro_avx2;
+        return encher_xoshiro_generico;
+    }
+
+    Xoshiro128Lanes<16> rng;
+    size_t posicao = 0;
+    size_t preenchidos = 0;
+    size_t blocos_proxima = 1;
+    alignas(64) uint32_t buffer[TAMANHO_BUFFER];
+};
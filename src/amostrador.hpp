@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "aleatorio.hpp"
+
+/*
+ * Sorteio ponderado com remoção dinâmica sobre uma árvore de Fenwick.
+ *
+ * Cada índice tem um peso inteiro; sortear um índice com probabilidade
+ * proporcional ao peso, zerar um peso (eliminação) ou restaurá-lo custam
+ * O(log n). Construir custa O(n). Os pesos são inteiros de ponto fixo, então
+ * as somas são exatas e um índice removido nunca é sorteado, por mais
+ * atualizações que a árvore acumule.
+ */
+class AmostradorPonderado {
+public:
+    // Peso de um handicap 1.0; handicaps fracionários são arredondados para
+    // múltiplos de 1/PESO_UNITARIO, com mínimo de um: um jogador com peso zero
+    // nunca poderia ser eliminado e travaria a partida.
+    static constexpr uint64_t PESO_UNITARIO = 1u << 16;
+
+    static uint64_t peso_de_handicap(double handicap) {
+        return std::max<uint64_t>(1, static_cast<uint64_t>(std::llround(std::max(0.0, handicap) * PESO_UNITARIO)));
+    }
+
+    AmostradorPonderado() = default;
+    explicit AmostradorPonderado(const std::vector<uint64_t>& pesos) { construir(pesos); }
+
+    void construir(const std::vector<uint64_t>& novos) {
+        pesos = novos;
+        arvore.assign(pesos.size() + 1, 0);
+        for (size_t i = 1; i <= pesos.size(); ++i) {
+            arvore[i] += pesos[i - 1];
+            size_t pai = i + (i & -i);
+            if (pai <= pesos.size()) arvore[pai] += arvore[i];
+        }
+        soma = 0;
+        for (uint64_t p : pesos) soma += p;
+        degrau = 1;
+        while (degrau * 2 <= pesos.size()) degrau *= 2;
+    }
+
+    void definir(size_t indice, uint64_t peso) {
+        uint64_t delta = peso - pesos[indice];  // aritmética modular: funciona para subtrair
+        pesos[indice] = peso;
+        soma += delta;
+        for (size_t i = indice + 1; i < arvore.size(); i += i & -i) arvore[i] += delta;
+    }
+
+    void remover(size_t indice) { definir(indice, 0); }
+
+    uint64_t peso(size_t indice) const { return pesos[indice]; }
+    uint64_t total() const { return soma; }
+    size_t tamanho() const { return pesos.size(); }
+
+    // Índice com probabilidade peso / total; exige total() > 0.
+    size_t sortear(GeradorLote& gen) const { return localizar(gen.abaixo64(soma)); }
+
+private:
+    // Menor índice cuja soma acumulada passa de `alvo`, descendo a árvore.
+    size_t localizar(uint64_t alvo) const {
+        size_t posicao = 0;
+        for (size_t passo = degrau; passo > 0; passo >>= 1) {
+            size_t proxima = posicao + passo;
+            if (proxima < arvore.size() && arvore[proxima] <= alvo) {
+                posicao = proxima;
+                alvo -= arvore[proxima];
+            }
+        }
+        return posicao;  // a árvore é 1-indexada, o resultado não
+    }
+
+    std::vector<uint64_t> pesos;
+    std::vector<uint64_t> arvore;
+    uint64_t soma = 0;
+    size_t degrau = 1;
+};
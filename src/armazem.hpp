@@ -0,0 +1,368 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * Armazém colunar de resultados, só de acréscimo.
+ *
+ * O arquivo começa com um cabeçalho de 16 bytes e segue com blocos
+ * independentes de até `partidas_por_bloco` partidas. Cada bloco tem um
+ * cabeçalho com o número de partidas e o tamanho de cada coluna, seguido das
+ * colunas, cada uma comprimida com a codificação que combina com ela:
+ *
+ *   semente      delta entre partidas consecutivas (zigzag) em varint
+ *   config       RLE: pares (identificador, repetições) em varint
+ *   vencedor     varint
+ *   rodadas      varint
+ *   eliminados   varint, tamanho da ordem de eliminação de cada partida
+ *   duracoes     varint, em µs, uma por rodada, partidas concatenadas
+ *   ordem        varint, ids eliminados, partidas concatenadas
+ *
+ * Quem lê decodifica só as colunas que usa e pode processar blocos em
+ * paralelo. Um bloco truncado no fim do arquivo (queda no meio da escrita) é
+ * ignorado na leitura e cortado pelo escritor antes de acrescentar ao arquivo.
+ */
+namespace armazem {
+
+constexpr char MAGICA_ARQUIVO[8] = {'C', 'A', 'D', 'C', 'O', 'L', '0', '1'};
+constexpr uint32_t MAGICA_BLOCO = 0x434f4c42;  // "BLOC"
+constexpr uint32_t VERSAO = 1;
+
+enum Coluna : uint32_t {
+    Semente,
+    Config,
+    Vencedor,
+    Rodadas,
+    Eliminados,
+    Duracoes,
+    Ordem,
+    NUM_COLUNAS,
+};
+
+struct CabecalhoArquivo {
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+};
+static_assert(sizeof(CabecalhoArquivo) == 16);
+
+struct CabecalhoBloco {
+    uint32_t magica;
+    uint32_t partidas;
+    uint64_t bytes[NUM_COLUNAS];  // tamanho comprimido de cada coluna, na ordem de `Coluna`
+};
+
+inline void escrever_varint(std::vector<uint8_t>& saida, uint64_t valor) {
+    while (valor >= 0x80) {
+        saida.push_back(static_cast<uint8_t>(valor) | 0x80);
+        valor >>= 7;
+    }
+    saida.push_back(static_cast<uint8_t>(valor));
+}
+
+inline uint64_t zigzag(int64_t valor) { return (static_cast<uint64_t>(valor) << 1) ^ static_cast<uint64_t>(valor >> 63); }
+inline int64_t desfazer_zigzag(uint64_t valor) { return static_cast<int64_t>(valor >> 1) ^ -static_cast<int64_t>(valor & 1); }
+
+// Lê um varint a partir de `p` e devolve a posição seguinte.
+inline const uint8_t* ler_varint(const uint8_t* p, uint64_t& valor) {
+    valor = 0;
+    for (int deslocamento = 0;; deslocamento += 7) {
+        uint8_t byte = *p++;
+        valor |= static_cast<uint64_t>(byte & 0x7f) << deslocamento;
+        if (byte < 0x80) return p;
+    }
+}
+
+// Como acima, mas sem passar de `fim`: um varint cortado ou longo demais
+// indica coluna corrompida e vira exceção, em vez de leitura fora do mapa.
+inline const uint8_t* ler_varint(const uint8_t* p, const uint8_t* fim, uint64_t& valor) {
+    valor = 0;
+    for (int deslocamento = 0; deslocamento < 64 && p < fim; deslocamento += 7) {
+        uint8_t byte = *p++;
+        valor |= static_cast<uint64_t>(byte & 0x7f) << deslocamento;
+        if (byte < 0x80) return p;
+    }
+    throw std::runtime_error("armazém corrompido: varint além do fim da coluna");
+}
+
+}  // namespace armazem
+
+// Acumula partidas em colunas na memória e grava um bloco comprimido a cada
+// `partidas_por_bloco` partidas e ao ser destruído. Não é thread-safe.
+class EscritorArmazem {
+public:
+    explicit EscritorArmazem(const std::string& caminho, uint32_t partidas_por_bloco = 65536)
+        : caminho(caminho), partidas_por_bloco(std::max<uint32_t>(1, partidas_por_bloco)) {
+        fd = ::open(caminho.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0) throw std::runtime_error("armazém " + caminho + ": " + std::strerror(errno));
+        try {
+            preparar_acrescimo();
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+    }
+
+    ~EscritorArmazem() {
+        try {
+            descarregar();
+        } catch (...) {
+        }
+        ::close(fd);
+    }
+
+    EscritorArmazem(const EscritorArmazem&) = delete;
+    EscritorArmazem& operator=(const EscritorArmazem&) = delete;
+
+    void acrescentar(uint64_t semente, uint64_t config, int vencedor, const std::vector<int>& ordem,
+                     const std::vector<uint32_t>& duracoes_us) {
+        using namespace armazem;
+        escrever_varint(colunas[Semente], zigzag(static_cast<int64_t>(semente - semente_anterior)));
+        semente_anterior = semente;
+        if (partidas == 0 || config != config_atual) {
+            fechar_sequencia_config();
+            config_atual = config;
+        }
+        ++repeticoes_config;
+        escrever_varint(colunas[Vencedor], static_cast<uint64_t>(std::max(0, vencedor)));
+        escrever_varint(colunas[Rodadas], duracoes_us.size());
+        escrever_varint(colunas[Eliminados], ordem.size());
+        for (uint32_t d : duracoes_us) escrever_varint(colunas[Duracoes], d);
+        for (int id : ordem) escrever_varint(colunas[Ordem], static_cast<uint64_t>(id));
+
+        if (++partidas == partidas_por_bloco) descarregar();
+    }
+
+    // Grava as partidas pendentes como um bloco, mesmo incompleto.
+    void descarregar() {
+        using namespace armazem;
+        if (partidas == 0) return;
+        fechar_sequencia_config();
+
+        CabecalhoBloco cabecalho{};
+        cabecalho.magica = MAGICA_BLOCO;
+        cabecalho.partidas = partidas;
+        for (uint32_t c = 0; c < NUM_COLUNAS; ++c) cabecalho.bytes[c] = colunas[c].size();
+
+        std::vector<uint8_t> bloco(sizeof(cabecalho));
+        std::memcpy(bloco.data(), &cabecalho, sizeof(cabecalho));
+        for (auto& coluna : colunas) {
+            bloco.insert(bloco.end(), coluna.begin(), coluna.end());
+            coluna.clear();
+        }
+        gravar(bloco.data(), bloco.size());  // uma escrita por bloco: O_APPEND não intercala
+
+        partidas = 0;
+        semente_anterior = 0;
+        ++blocos_gravados;
+    }
+
+    uint64_t get_blocos_gravados() const { return blocos_gravados; }
+
+private:
+    // Antes de acrescentar a um arquivo existente: confere o cabeçalho e corta
+    // a cauda a partir do ponto em que o leitor pararia (bloco rasgado por uma
+    // queda no meio da escrita), senão os blocos novos ficariam invisíveis
+    // atrás dela.
+    void preparar_acrescimo() {
+        using namespace armazem;
+        struct stat info;
+        if (::fstat(fd, &info) < 0) erro(std::strerror(errno));
+        const uint64_t tamanho = static_cast<uint64_t>(info.st_size);
+
+        CabecalhoArquivo esperado{};
+        std::memcpy(esperado.magica, MAGICA_ARQUIVO, sizeof(esperado.magica));
+        esperado.versao = VERSAO;
+        if (tamanho < sizeof(CabecalhoArquivo)) {
+            // Vazio ou com o próprio cabeçalho rasgado: recomeça do zero.
+            CabecalhoArquivo lido{};
+            if (tamanho > 0 && ::pread(fd, &lido, tamanho, 0) != static_cast<ssize_t>(tamanho)) erro("leitura curta");
+            if (std::memcmp(&lido, &esperado, tamanho) != 0) erro("formato desconhecido");
+            truncar(0);
+            gravar(&esperado, sizeof(esperado));
+            return;
+        }
+        CabecalhoArquivo lido;
+        if (::pread(fd, &lido, sizeof(lido), 0) != sizeof(lido)) erro("leitura curta");
+        if (std::memcmp(lido.magica, MAGICA_ARQUIVO, sizeof(lido.magica)) != 0 || lido.versao != VERSAO) {
+            erro("formato desconhecido");
+        }
+
+        uint64_t posicao = sizeof(CabecalhoArquivo);
+        while (tamanho - posicao >= sizeof(CabecalhoBloco)) {
+            CabecalhoBloco cabecalho;
+            if (::pread(fd, &cabecalho, sizeof(cabecalho), static_cast<off_t>(posicao)) != sizeof(cabecalho)) {
+                erro("leitura curta");
+            }
+            if (cabecalho.magica != MAGICA_BLOCO) break;
+            const uint64_t disponivel = tamanho - posicao - sizeof(cabecalho);
+            uint64_t corpo = 0;
+            bool cabe = true;
+            for (uint64_t b : cabecalho.bytes) {
+                if (b > disponivel - corpo) {
+                    cabe = false;
+                    break;
+                }
+                corpo += b;
+            }
+            if (!cabe) break;
+            posicao += sizeof(cabecalho) + corpo;
+        }
+        if (posicao < tamanho) truncar(posicao);
+    }
+
+    void truncar(uint64_t tamanho) {
+        if (::ftruncate(fd, static_cast<off_t>(tamanho)) < 0) erro(std::strerror(errno));
+    }
+
+    [[noreturn]] void erro(const std::string& motivo) const {
+        throw std::runtime_error("armazém " + caminho + ": " + motivo);
+    }
+
+    void fechar_sequencia_config() {
+        if (repeticoes_config == 0) return;
+        armazem::escrever_varint(colunas[armazem::Config], config_atual);
+        armazem::escrever_varint(colunas[armazem::Config], repeticoes_config);
+        repeticoes_config = 0;
+    }
+
+    void gravar(const void* dados, size_t tamanho) {
+        const char* p = static_cast<const char*>(dados);
+        while (tamanho > 0) {
+            ssize_t n = ::write(fd, p, tamanho);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("armazém " + caminho + ": " + std::strerror(errno));
+            }
+            p += n;
+            tamanho -= static_cast<size_t>(n);
+        }
+    }
+
+    std::string caminho;
+    uint32_t partidas_por_bloco;
+    int fd = -1;
+    std::vector<uint8_t> colunas[armazem::NUM_COLUNAS];
+    uint32_t partidas = 0;
+    uint64_t semente_anterior = 0;
+    uint64_t config_atual = 0;
+    uint64_t repeticoes_config = 0;
+    uint64_t blocos_gravados = 0;
+};
+
+// Mapeia o armazém só para leitura e indexa os blocos completos. As colunas
+// são lidas direto do mapeamento, sob demanda: consultar uma coluna não traz
+// as outras para a memória.
+class LeitorArmazem {
+public:
+    struct Bloco {
+        uint32_t partidas;
+        const uint8_t* inicio[armazem::NUM_COLUNAS];
+        const uint8_t* fim[armazem::NUM_COLUNAS];
+    };
+
+    explicit LeitorArmazem(const std::string& caminho) {
+        int fd = ::open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw std::runtime_error("armazém " + caminho + ": " + std::strerror(errno));
+        struct stat info;
+        if (::fstat(fd, &info) < 0) {
+            ::close(fd);
+            throw std::runtime_error("armazém " + caminho + ": " + std::strerror(errno));
+        }
+        tamanho = static_cast<size_t>(info.st_size);
+        if (tamanho < sizeof(armazem::CabecalhoArquivo)) {
+            ::close(fd);
+            throw std::runtime_error("armazém " + caminho + ": arquivo vazio ou truncado");
+        }
+        void* mapa = ::mmap(nullptr, tamanho, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapa == MAP_FAILED) throw std::runtime_error("armazém " + caminho + ": " + std::strerror(errno));
+        dados = static_cast<const uint8_t*>(mapa);
+
+        armazem::CabecalhoArquivo cabecalho;
+        std::memcpy(&cabecalho, dados, sizeof(cabecalho));
+        if (std::memcmp(cabecalho.magica, armazem::MAGICA_ARQUIVO, sizeof(cabecalho.magica)) != 0 ||
+            cabecalho.versao != armazem::VERSAO) {
+            ::munmap(mapa, tamanho);
+            throw std::runtime_error("armazém " + caminho + ": formato desconhecido");
+        }
+        try {
+            indexar();
+        } catch (...) {
+            ::munmap(mapa, tamanho);
+            dados = nullptr;
+            throw;
+        }
+    }
+
+    ~LeitorArmazem() {
+        if (dados) ::munmap(const_cast<uint8_t*>(dados), tamanho);
+    }
+
+    LeitorArmazem(const LeitorArmazem&) = delete;
+    LeitorArmazem& operator=(const LeitorArmazem&) = delete;
+
+    const std::vector<Bloco>& get_blocos() const { return blocos; }
+    uint64_t get_partidas() const { return partidas; }
+    size_t get_bytes_ignorados() const { return ignorados; }
+
+private:
+    void indexar() {
+        size_t posicao = sizeof(armazem::CabecalhoArquivo);
+        while (tamanho - posicao >= sizeof(armazem::CabecalhoBloco)) {
+            armazem::CabecalhoBloco cabecalho;
+            std::memcpy(&cabecalho, dados + posicao, sizeof(cabecalho));
+            if (cabecalho.magica != armazem::MAGICA_BLOCO) break;
+            // Soma coluna a coluna contra o que resta: tamanhos absurdos não
+            // dão a volta no size_t e parecem caber.
+            const size_t disponivel = tamanho - posicao - sizeof(cabecalho);
+            size_t corpo = 0;
+            bool cabe = true;
+            for (uint64_t b : cabecalho.bytes) {
+                if (b > disponivel - corpo) {
+                    cabe = false;
+                    break;
+                }
+                corpo += b;
+            }
+            if (!cabe) break;  // bloco truncado
+            // Cada partida ocupa ao menos um byte nas colunas por partida.
+            for (uint32_t c : {armazem::Vencedor, armazem::Rodadas, armazem::Eliminados}) {
+                if (cabecalho.bytes[c] < cabecalho.partidas) {
+                    throw std::runtime_error("armazém corrompido: bloco em " + std::to_string(posicao) +
+                                             " declara mais partidas do que as colunas comportam");
+                }
+            }
+
+            Bloco bloco{};
+            bloco.partidas = cabecalho.partidas;
+            const uint8_t* p = dados + posicao + sizeof(cabecalho);
+            for (uint32_t c = 0; c < armazem::NUM_COLUNAS; ++c) {
+                bloco.inicio[c] = p;
+                p += cabecalho.bytes[c];
+                bloco.fim[c] = p;
+            }
+            blocos.push_back(bloco);
+            partidas += cabecalho.partidas;
+            posicao += sizeof(cabecalho) + corpo;
+        }
+        ignorados = tamanho - posicao;
+        ::madvise(const_cast<uint8_t*>(dados), tamanho, MADV_SEQUENTIAL);
+    }
+
+    const uint8_t* dados = nullptr;
+    size_t tamanho = 0;
+    std::vector<Bloco> blocos;
+    uint64_t partidas = 0;
+    size_t ignorados = 0;
+};
@@ -0,0 +1,85 @@
+// Bot de referência para o modo de jogadores externos.
+//
+// Conecta no socket do coordenador, registra `--jogadores` jogadores numa só
+// conexão e responde cada "música parou" com um pedido de cadeira. Os pedidos
+// de todos os jogadores hospedados saem numa única escrita.
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "aleatorio.hpp"
+#include "opcoes.hpp"
+#include "protocolo.hpp"
+
+int conectar(const std::string& caminho) {
+    sockaddr_un endereco = endereco_unix(caminho);
+    // O coordenador pode ainda não ter criado o socket quando o bot sobe.
+    for (int tentativa = 0; tentativa < 500; ++tentativa) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) == 0) {
+            return fd;
+        }
+        ::close(fd);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1;
+}
+
+int main(int argc, char** argv) {
+    Opcoes opcoes(argc, argv);
+    std::string caminho = opcoes.texto("socket", "/tmp/jogo_das_cadeiras.sock");
+    int quantidade = static_cast<int>(opcoes.inteiro("jogadores", 1));
+    int reacao_max_us = static_cast<int>(opcoes.inteiro("reacao-max-us", 0));
+
+    int fd = conectar(caminho);
+    if (fd < 0) {
+        std::cerr << "BotJogador: não foi possível conectar em " << caminho << "\n";
+        return 1;
+    }
+
+    CanalMensagens canal(fd);
+    canal.enfileirar(criar_mensagem(TipoMensagem::Registro, 0, 0, static_cast<uint32_t>(quantidade)));
+    canal.descarregar();
+
+    GeradorLote gen(std::random_device{}());
+    std::vector<Mensagem> recebidas;
+    std::vector<uint32_t> chamados;
+    bool fim = false;
+
+    while (!fim) {
+        recebidas.clear();
+        if (!canal.receber(recebidas)) break;
+
+        chamados.clear();
+        uint32_t rodada = 0;
+        for (const Mensagem& m : recebidas) {
+            switch (static_cast<TipoMensagem>(m.tipo)) {
+            case TipoMensagem::MusicaParou:
+                chamados.push_back(m.jogador);
+                rodada = m.rodada;
+                break;
+            case TipoMensagem::FimDeJogo:
+                fim = true;
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (chamados.empty()) continue;
+        if (reacao_max_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(gen.entre(0, reacao_max_us)));
+        }
+        for (uint32_t id : chamados) {
+            canal.enfileirar(criar_mensagem(TipoMensagem::PedidoCadeira, id, rodada));
+        }
+        canal.descarregar();
+    }
+
+    ::close(fd);
+    return 0;
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aleatorio.hpp"
+#include "partida.hpp"
+
+/*
+ * Cache em disco de resultados de partidas do motor em pool. Dada a
+ * especificação (configuração completa e semente), a partida é determinística,
+ * então o resultado pode ser reaproveitado entre execuções.
+ *
+ * O arquivo tem tamanho fixo e é mapeado com `mmap`: um cabeçalho e uma
+ * tabela de entradas de 64 bytes endereçada pelo hash da especificação, com
+ * sondagem linear limitada a um grupo de 8 entradas. Quando o grupo está
+ * cheio, uma entrada dele é substituída, então o cache nunca passa do tamanho
+ * pedido. Se a versão das regras (`VERSAO_REGRAS_PARTIDA`) ou o formato do
+ * arquivo mudarem, o conteúdo antigo é descartado ao abrir.
+ *
+ * Um processo por arquivo (`flock` exclusivo); dentro do processo, as
+ * operações são serializadas por um mutex.
+ */
+class CacheResultados {
+public:
+    static constexpr uint32_t VERSAO_FORMATO = 2;
+    static constexpr size_t ENTRADAS_POR_GRUPO = 8;
+
+    CacheResultados(const std::string& caminho, size_t tamanho_mb) {
+        size_t entradas = 1;
+        while (entradas * 2 * sizeof(Entrada) <= tamanho_mb * 1024 * 1024) entradas *= 2;
+        entradas = std::max(entradas, ENTRADAS_POR_GRUPO);
+        tamanho = sizeof(Cabecalho) + entradas * sizeof(Entrada);
+
+        fd = ::open(caminho.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) throw std::runtime_error("cache " + caminho + ": " + std::strerror(errno));
+        if (::flock(fd, LOCK_EX | LOCK_NB) < 0) {
+            ::close(fd);
+            throw std::runtime_error("cache " + caminho + " já está em uso por outro processo");
+        }
+
+        struct stat info;
+        bool reaproveitar = ::fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) == tamanho;
+        if (!reaproveitar && ::ftruncate(fd, 0) < 0) erro(caminho);
+        if (::ftruncate(fd, static_cast<off_t>(tamanho)) < 0) erro(caminho);
+
+        void* mapa = ::mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapa == MAP_FAILED) erro(caminho);
+        cabecalho = static_cast<Cabecalho*>(mapa);
+        tabela = reinterpret_cast<Entrada*>(static_cast<char*>(mapa) + sizeof(Cabecalho));
+        mascara = entradas - 1;
+
+        if (std::memcmp(cabecalho->magica, MAGICA, sizeof(cabecalho->magica)) != 0 ||
+            cabecalho->versao_formato != VERSAO_FORMATO || cabecalho->versao_regras != VERSAO_REGRAS_PARTIDA ||
+            cabecalho->entradas != entradas) {
+            std::memset(mapa, 0, tamanho);  // versão nova ou arquivo estranho: começa vazio
+            std::memcpy(cabecalho->magica, MAGICA, sizeof(cabecalho->magica));
+            cabecalho->versao_formato = VERSAO_FORMATO;
+            cabecalho->versao_regras = VERSAO_REGRAS_PARTIDA;
+            cabecalho->entradas = entradas;
+        }
+    }
+
+    ~CacheResultados() {
+        if (cabecalho) ::munmap(cabecalho, tamanho);
+        if (fd >= 0) ::close(fd);
+    }
+
+    CacheResultados(const CacheResultados&) = delete;
+    CacheResultados& operator=(const CacheResultados&) = delete;
+
+    // Preenche `resultado` (com o id da especificação) se ela já foi jogada.
+    bool buscar(const EspecJogo& espec, ResultadoCompacto& resultado) {
+        EspecJogo chave = normalizar(espec);
+        uint64_t h = hash(chave);
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < ENTRADAS_POR_GRUPO; ++i) {
+            const Entrada& e = tabela[(h + i) & mascara];
+            if (e.hash == 0) break;
+            if (e.hash == h && std::memcmp(&e.espec, &chave, sizeof(chave)) == 0) {
+                resultado = ResultadoCompacto{espec.id, e.vencedor, e.rodadas, e.assinatura};
+                acertos.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        faltas.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void guardar(const EspecJogo& espec, const ResultadoCompacto& resultado) {
+        EspecJogo chave = normalizar(espec);
+        uint64_t h = hash(chave);
+        std::lock_guard<std::mutex> lock(mutex);
+        Entrada* destino = nullptr;
+        for (size_t i = 0; i < ENTRADAS_POR_GRUPO && !destino; ++i) {
+            Entrada& e = tabela[(h + i) & mascara];
+            if (e.hash == 0 || (e.hash == h && std::memcmp(&e.espec, &chave, sizeof(chave)) == 0)) destino = &e;
+        }
+        if (!destino) {
+            // Grupo cheio: substitui uma entrada escolhida pelos bits altos do hash.
+            destino = &tabela[(h + (h >> 32) % ENTRADAS_POR_GRUPO) & mascara];
+            substituicoes.fetch_add(1, std::memory_order_relaxed);
+        }
+        destino->hash = h;
+        destino->espec = chave;
+        destino->vencedor = resultado.vencedor;
+        destino->rodadas = resultado.rodadas;
+        destino->assinatura = resultado.assinatura;
+    }
+
+    uint64_t get_acertos() const { return acertos.load(std::memory_order_relaxed); }
+    uint64_t get_faltas() const { return faltas.load(std::memory_order_relaxed); }
+    uint64_t get_substituicoes() const { return substituicoes.load(std::memory_order_relaxed); }
+    size_t get_capacidade() const { return mascara + 1; }
+
+private:
+    static constexpr char MAGICA[8] = {'C', 'A', 'D', 'E', 'I', 'R', 'A', 'S'};
+
+    struct Cabecalho {
+        char magica[8];
+        uint32_t versao_formato;
+        uint32_t versao_regras;
+        uint64_t entradas;
+        char reservado[40];
+    };
+    static_assert(sizeof(Cabecalho) == 64, "o cabeçalho ocupa uma linha de cache");
+
+    struct Entrada {
+        uint64_t hash;  // 0 = livre
+        EspecJogo espec;
+        uint32_t vencedor;
+        uint32_t rodadas;
+        uint32_t assinatura;
+        uint32_t reservado[3];
+    };
+    static_assert(sizeof(Entrada) == 64, "cada entrada ocupa uma linha de cache");
+
+    // A chave guarda só o que decide a partida, na forma canônica, para que
+    // especificações equivalentes caiam na mesma entrada e bytes sem uso não
+    // distingam nem confundam partidas. O id é do pedido e a música só ocupa
+    // o worker; ficam fora. Do cronograma valem as entradas que as n - 1
+    // rodadas leem, com 0 lido como 1 e a repetição final colapsada.
+    static EspecJogo normalizar(const EspecJogo& espec) {
+        EspecJogo chave{};
+        chave.num_jogadores = std::max<uint32_t>(1, espec.num_jogadores);
+        chave.semente = espec.semente;
+        chave.politica = espec.politica == static_cast<uint8_t>(PoliticaReacao::Persistente)
+                             ? espec.politica : static_cast<uint8_t>(PoliticaReacao::Aleatoria);
+        const int rodadas = static_cast<int>(std::min<uint32_t>(chave.num_jogadores - 1, sizeof(chave.cronograma)));
+        int tam = std::max(1, rodadas);
+        for (int r = 0; r < tam; ++r) chave.cronograma[r] = static_cast<uint8_t>(espec.remocoes_na_rodada(r));
+        while (tam > 1 && chave.cronograma[tam - 1] == chave.cronograma[tam - 2]) chave.cronograma[--tam] = 0;
+        chave.tam_cronograma = static_cast<uint8_t>(tam);
+        return chave;
+    }
+
+    static uint64_t hash(const EspecJogo& espec) {
+        uint64_t palavras[sizeof(EspecJogo) / 8];
+        std::memcpy(palavras, &espec, sizeof(espec));
+        uint64_t h = 0;
+        for (uint64_t p : palavras) h = SplitMix64::na_posicao(h ^ p, 0);
+        return h | 1;  // nunca 0, que marca entrada livre
+    }
+
+    [[noreturn]] void erro(const std::string& caminho) {
+        std::string mensagem = "cache " + caminho + ": " + std::strerror(errno);
+        ::close(fd);
+        fd = -1;
+        throw std::runtime_error(mensagem);
+    }
+
+    int fd = -1;
+    size_t tamanho = 0;
+    Cabecalho* cabecalho = nullptr;
+    Entrada* tabela = nullptr;
+    size_t mascara = 0;
+    std::mutex mutex;
+    std::atomic<uint64_t> acertos{0};
+    std::atomic<uint64_t> faltas{0};
+    std::atomic<uint64_t> substituicoes{0};
+};
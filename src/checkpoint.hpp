@@ -0,0 +1,248 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "aleatorio.hpp"
+#include "armazem.hpp"
+
+/*
+ * Checkpoints binários de execuções longas.
+ *
+ * O arquivo tem um cabeçalho de 32 bytes (mágica, versão, tamanho e soma do
+ * corpo) e o corpo, que é livre: quem salva escreve com `Escrita` e quem
+ * retoma lê na mesma ordem com `Leitura`. Inteiros vão em varint, como no
+ * armazém. A gravação vai para um arquivo temporário, com `fsync`, e só então
+ * substitui o anterior com `rename`: uma queda no meio deixa o checkpoint
+ * anterior intacto.
+ */
+namespace checkpoint {
+
+constexpr char MAGICA[8] = {'C', 'A', 'D', 'C', 'K', 'P', '0', '1'};
+constexpr uint32_t VERSAO = 1;
+
+struct Cabecalho {
+    char magica[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t bytes;
+    uint64_t soma;
+};
+static_assert(sizeof(Cabecalho) == 32);
+
+inline uint64_t somar(const std::vector<uint8_t>& dados) {
+    uint64_t h = dados.size();
+    for (size_t i = 0; i < dados.size(); i += 8) {
+        uint64_t palavra = 0;
+        std::memcpy(&palavra, dados.data() + i, std::min<size_t>(8, dados.size() - i));
+        h = SplitMix64::na_posicao(h ^ palavra, 0);
+    }
+    return h;
+}
+
+class Escrita {
+public:
+    void natural(uint64_t valor) { armazem::escrever_varint(dados, valor); }
+    void inteiro(int64_t valor) { armazem::escrever_varint(dados, armazem::zigzag(valor)); }
+    void real(double valor) {
+        uint64_t bits;
+        std::memcpy(&bits, &valor, sizeof(bits));
+        natural(bits);
+    }
+    void gerador(const GeradorLote& gen) { gen.salvar(dados); }
+
+    std::vector<uint8_t>& get_dados() { return dados; }
+
+private:
+    std::vector<uint8_t> dados;
+};
+
+// Lê o corpo na ordem em que foi escrito; lança se passar do fim.
+class Leitura {
+public:
+    explicit Leitura(const std::vector<uint8_t>& dados) : p(dados.data()), fim(dados.data() + dados.size()) {}
+
+    uint64_t natural() {
+        uint64_t valor = 0;
+        for (int deslocamento = 0; deslocamento < 64; deslocamento += 7) {
+            if (p == fim) truncado();
+            uint8_t byte = *p++;
+            valor |= static_cast<uint64_t>(byte & 0x7f) << deslocamento;
+            if (byte < 0x80) return valor;
+        }
+        truncado();
+    }
+    int64_t inteiro() { return armazem::desfazer_zigzag(natural()); }
+    double real() {
+        uint64_t bits = natural();
+        double valor;
+        std::memcpy(&valor, &bits, sizeof(valor));
+        return valor;
+    }
+    void gerador(GeradorLote& gen) {
+        size_t n = gen.restaurar(p, static_cast<size_t>(fim - p));
+        if (n == 0) truncado();
+        p += n;
+    }
+
+    // Tamanho de uma lista, limitado pelo que ainda resta no corpo (cada
+    // item ocupa ao menos um byte): um corpo corrompido não pede gigabytes.
+    size_t tamanho() {
+        uint64_t n = natural();
+        if (n > static_cast<uint64_t>(fim - p)) truncado();
+        return static_cast<size_t>(n);
+    }
+
+    bool no_fim() const { return p == fim; }
+
+private:
+    [[noreturn]] static void truncado() { throw std::runtime_error("checkpoint truncado ou inválido"); }
+
+    const uint8_t* p;
+    const uint8_t* fim;
+};
+
+inline void gravar(const std::string& caminho, const std::vector<uint8_t>& corpo) {
+    Cabecalho cabecalho{};
+    std::memcpy(cabecalho.magica, MAGICA, sizeof(cabecalho.magica));
+    cabecalho.versao = VERSAO;
+    cabecalho.bytes = corpo.size();
+    cabecalho.soma = somar(corpo);
+
+    std::string temporario = caminho + ".tmp";
+    int fd = ::open(temporario.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) throw std::runtime_error("checkpoint " + temporario + ": " + std::strerror(errno));
+    auto escrever = [&](const void* dados, size_t tamanho) {
+        const char* q = static_cast<const char*>(dados);
+        while (tamanho > 0) {
+            ssize_t n = ::write(fd, q, tamanho);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) return false;
+            q += n;
+            tamanho -= static_cast<size_t>(n);
+        }
+        return true;
+    };
+    bool ok = escrever(&cabecalho, sizeof(cabecalho)) && escrever(corpo.data(), corpo.size()) && ::fsync(fd) == 0;
+    int erro = errno;
+    ::close(fd);
+    if (!ok || ::rename(temporario.c_str(), caminho.c_str()) < 0) {
+        if (ok) erro = errno;
+        ::unlink(temporario.c_str());
+        throw std::runtime_error("checkpoint " + caminho + ": " + std::strerror(erro));
+    }
+}
+
+// Lê e valida o checkpoint; devolve o corpo.
+inline std::vector<uint8_t> ler(const std::string& caminho) {
+    int fd = ::open(caminho.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("checkpoint " + caminho + ": " + std::strerror(errno));
+    Cabecalho cabecalho{};
+    std::vector<uint8_t> corpo;
+    bool ok = ::read(fd, &cabecalho, sizeof(cabecalho)) == static_cast<ssize_t>(sizeof(cabecalho)) &&
+              std::memcmp(cabecalho.magica, MAGICA, sizeof(cabecalho.magica)) == 0 && cabecalho.versao == VERSAO;
+    if (ok) {
+        struct stat info;
+        ok = ::fstat(fd, &info) == 0 && static_cast<uint64_t>(info.st_size) == sizeof(cabecalho) + cabecalho.bytes;
+    }
+    if (ok) {
+        corpo.resize(cabecalho.bytes);
+        size_t lidos = 0;
+        while (lidos < corpo.size()) {
+            ssize_t n = ::read(fd, corpo.data() + lidos, corpo.size() - lidos);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            lidos += static_cast<size_t>(n);
+        }
+        ok = lidos == corpo.size() && somar(corpo) == cabecalho.soma;
+    }
+    ::close(fd);
+    if (!ok) throw std::runtime_error("checkpoint " + caminho + ": formato desconhecido ou corrompido");
+    return corpo;
+}
+
+}  // namespace checkpoint
+
+// Pede um checkpoint a cada `intervalo` e grava numa thread de fundo. O
+// motor consulta `pedido()` (uma leitura atômica relaxada) em pontos onde o
+// estado é retomável, serializa e chama `entregar`; a escrita e o `fsync`
+// não param o jogo.
+class GravadorCheckpoint {
+public:
+    GravadorCheckpoint(const std::string& caminho, std::chrono::milliseconds intervalo)
+        : caminho(caminho), intervalo(intervalo) {
+        gravador = std::thread(&GravadorCheckpoint::executar, this);
+    }
+
+    ~GravadorCheckpoint() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            parar = true;
+        }
+        cv.notify_one();
+        gravador.join();
+    }
+
+    GravadorCheckpoint(const GravadorCheckpoint&) = delete;
+    GravadorCheckpoint& operator=(const GravadorCheckpoint&) = delete;
+
+    bool pedido() const { return pedir.load(std::memory_order_relaxed); }
+
+    void entregar(std::vector<uint8_t> corpo) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pendente = std::move(corpo);
+            tem_pendente = true;
+            pedir.store(false, std::memory_order_relaxed);
+        }
+        cv.notify_one();
+    }
+
+    uint64_t get_gravados() const { return gravados.load(std::memory_order_relaxed); }
+
+private:
+    void executar() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            if (cv.wait_for(lock, intervalo, [&] { return parar; })) return;
+            pedir.store(true, std::memory_order_relaxed);
+            cv.wait(lock, [&] { return tem_pendente || parar; });
+            if (!tem_pendente) return;
+            std::vector<uint8_t> corpo = std::move(pendente);
+            tem_pendente = false;
+            lock.unlock();
+            try {
+                checkpoint::gravar(caminho, corpo);
+                gravados.fetch_add(1, std::memory_order_relaxed);
+            } catch (const std::exception& e) {
+                std::fprintf(stderr, "%s\n", e.what());  // o jogo segue; tenta de novo no próximo intervalo
+            }
+            lock.lock();
+        }
+    }
+
+    std::string caminho;
+    std::chrono::milliseconds intervalo;
+    std::atomic<bool> pedir{false};
+    std::atomic<uint64_t> gravados{0};
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint8_t> pendente;
+    bool tem_pendente = false;
+    bool parar = false;
+    std::thread gravador;
+};
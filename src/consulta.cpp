@@ -0,0 +1,218 @@
+// Consultas sobre o armazém colunar de resultados. O arquivo é mapeado com
+// `mmap` e os blocos são divididos entre threads; cada consulta decodifica só
+// as colunas de que precisa.
+//
+//   ConsultaResultados resumo   --armazem resultados.col
+//   ConsultaResultados vitorias --armazem resultados.col [--config ID]
+//   ConsultaResultados duracoes --armazem resultados.col [--config ID]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "armazem.hpp"
+#include "histograma.hpp"
+#include "opcoes.hpp"
+
+namespace {
+
+constexpr int MAX_RODADAS_DETALHADAS = 16;
+
+struct Agregado {
+    uint64_t partidas = 0;
+    std::vector<uint64_t> vitorias;
+    std::map<uint64_t, uint64_t> configs;
+    Histograma duracoes;
+    std::vector<Histograma> duracoes_por_rodada = std::vector<Histograma>(MAX_RODADAS_DETALHADAS);
+
+    void somar(const Agregado& outro) {
+        partidas += outro.partidas;
+        if (vitorias.size() < outro.vitorias.size()) vitorias.resize(outro.vitorias.size(), 0);
+        for (size_t i = 0; i < outro.vitorias.size(); ++i) vitorias[i] += outro.vitorias[i];
+        for (auto [config, n] : outro.configs) configs[config] += n;
+        duracoes.somar(outro.duracoes);
+        for (int r = 0; r < MAX_RODADAS_DETALHADAS; ++r) duracoes_por_rodada[r].somar(outro.duracoes_por_rodada[r]);
+    }
+};
+
+struct Consulta {
+    bool vitorias = false;
+    bool duracoes = false;
+    bool filtrar = false;
+    uint64_t config = 0;
+};
+
+// Expande a coluna RLE de configuração numa máscara por partida.
+void selecionar(const LeitorArmazem::Bloco& bloco, const Consulta& consulta, std::vector<uint8_t>& selecionadas,
+                Agregado& agregado) {
+    selecionadas.assign(bloco.partidas, consulta.filtrar ? 0 : 1);
+    const uint8_t* p = bloco.inicio[armazem::Config];
+    size_t partida = 0;
+    while (p < bloco.fim[armazem::Config] && partida < bloco.partidas) {
+        uint64_t config, repeticoes;
+        const uint8_t* fim_coluna = bloco.fim[armazem::Config];
+        p = armazem::ler_varint(armazem::ler_varint(p, fim_coluna, config), fim_coluna, repeticoes);
+        size_t fim = std::min<size_t>(bloco.partidas, partida + repeticoes);
+        if (!consulta.filtrar || config == consulta.config) {
+            agregado.configs[config] += fim - partida;
+            std::fill(selecionadas.begin() + partida, selecionadas.begin() + fim, 1);
+        }
+        partida = fim;
+    }
+}
+
+void processar_bloco(const LeitorArmazem::Bloco& bloco, const Consulta& consulta, Agregado& agregado,
+                     std::vector<uint8_t>& selecionadas) {
+    selecionar(bloco, consulta, selecionadas, agregado);
+    for (uint8_t s : selecionadas) agregado.partidas += s;
+
+    if (consulta.vitorias) {
+        const uint8_t* p = bloco.inicio[armazem::Vencedor];
+        size_t bytes = static_cast<size_t>(bloco.fim[armazem::Vencedor] - p);
+        if (agregado.vitorias.size() < 128) agregado.vitorias.resize(128, 0);
+        if (bytes == bloco.partidas) {
+            // Todos os ids cabem num byte: contagem direta, sem decodificar varints.
+            // Um byte com o bit de continuação aqui só pode ser lixo.
+            uint64_t contagem[256] = {};
+            for (size_t i = 0; i < bytes; ++i) contagem[p[i]] += selecionadas[i];
+            for (int id = 128; id < 256; ++id) {
+                if (contagem[id]) throw std::runtime_error("armazém corrompido: coluna de vencedores");
+            }
+            for (int id = 0; id < 128; ++id) agregado.vitorias[id] += contagem[id];
+        } else {
+            for (size_t i = 0; i < bloco.partidas; ++i) {
+                uint64_t vencedor;
+                p = armazem::ler_varint(p, bloco.fim[armazem::Vencedor], vencedor);
+                if (!selecionadas[i]) continue;
+                if (vencedor >= agregado.vitorias.size()) agregado.vitorias.resize(vencedor + 1, 0);
+                ++agregado.vitorias[vencedor];
+            }
+        }
+    }
+
+    if (consulta.duracoes) {
+        const uint8_t* rodadas = bloco.inicio[armazem::Rodadas];
+        const uint8_t* duracoes = bloco.inicio[armazem::Duracoes];
+        for (size_t i = 0; i < bloco.partidas; ++i) {
+            uint64_t n;
+            rodadas = armazem::ler_varint(rodadas, bloco.fim[armazem::Rodadas], n);
+            for (uint64_t r = 0; r < n; ++r) {
+                uint64_t us;
+                duracoes = armazem::ler_varint(duracoes, bloco.fim[armazem::Duracoes], us);
+                if (!selecionadas[i]) continue;
+                agregado.duracoes.registrar(us);
+                if (r < MAX_RODADAS_DETALHADAS) agregado.duracoes_por_rodada[r].registrar(us);
+            }
+        }
+    }
+}
+
+Agregado executar(const LeitorArmazem& leitor, const Consulta& consulta, int num_threads) {
+    const auto& blocos = leitor.get_blocos();
+    std::atomic<size_t> proximo{0};
+    std::vector<Agregado> parciais(num_threads);
+    std::vector<std::thread> threads;
+    std::mutex mutex_erro;
+    std::exception_ptr erro;  // o primeiro bloco corrompido encerra a consulta
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t] {
+            std::vector<uint8_t> selecionadas;
+            try {
+                for (size_t b = proximo++; b < blocos.size(); b = proximo++) {
+                    processar_bloco(blocos[b], consulta, parciais[t], selecionadas);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_erro);
+                if (!erro) erro = std::current_exception();
+                proximo = blocos.size();
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    if (erro) std::rethrow_exception(erro);
+
+    Agregado total;
+    for (const Agregado& parcial : parciais) total.somar(parcial);
+    return total;
+}
+
+void imprimir_vitorias(const Agregado& a) {
+    std::cout << "assento  vitórias     taxa\n";
+    for (size_t id = 1; id < a.vitorias.size(); ++id) {
+        if (a.vitorias[id] == 0) continue;
+        std::cout << std::left << std::setw(9) << ("P" + std::to_string(id)) << std::setw(13) << a.vitorias[id]
+                  << std::fixed << std::setprecision(4) << 100.0 * a.vitorias[id] / a.partidas << "%\n";
+    }
+}
+
+void imprimir_duracoes(const Agregado& a) {
+    auto linha = [](const std::string& rotulo, const Histograma& h) {
+        std::cout << std::left << std::setw(9) << rotulo << std::setw(13) << h.get_total();
+        for (double q : {0.5, 0.9, 0.99, 0.999}) std::cout << std::setw(11) << h.quantil(q);
+        std::cout << h.quantil(1.0) << "\n";
+    };
+    std::cout << "rodada   amostras     p50 (µs)   p90        p99        p99,9      máx\n";
+    linha("todas", a.duracoes);
+    for (int r = 0; r < MAX_RODADAS_DETALHADAS; ++r) {
+        if (a.duracoes_por_rodada[r].get_total() > 0) linha(std::to_string(r + 1), a.duracoes_por_rodada[r]);
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Opcoes opcoes(argc, argv);
+    if (!opcoes.tem("armazem")) {
+        std::cerr << "uso: ConsultaResultados [resumo|vitorias|duracoes] --armazem ARQUIVO [--config ID] "
+                     "[--threads N]\n";
+        return 2;
+    }
+    std::string modo = opcoes.modo().empty() ? "resumo" : opcoes.modo();
+
+    Consulta consulta;
+    consulta.vitorias = modo == "vitorias" || modo == "resumo";
+    consulta.duracoes = modo == "duracoes" || modo == "resumo";
+    int num_threads = static_cast<int>(
+        opcoes.inteiro("threads", std::max(1u, std::thread::hardware_concurrency())));
+
+    try {
+        if (opcoes.tem("config")) {
+            consulta.filtrar = true;
+            size_t lidos = 0;
+            const std::string texto = opcoes.texto("config");
+            try {
+                consulta.config = std::stoull(texto, &lidos, 0);
+            } catch (const std::logic_error&) {
+                lidos = 0;
+            }
+            if (lidos == 0 || lidos != texto.size()) throw std::runtime_error("--config inválido: " + texto);
+        }
+        auto inicio = std::chrono::steady_clock::now();
+        LeitorArmazem leitor(opcoes.texto("armazem"));
+        Agregado a = executar(leitor, consulta, num_threads);
+        double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+        std::cout << a.partidas << " de " << leitor.get_partidas() << " partidas em " << leitor.get_blocos().size()
+                  << " blocos, " << segundos << " s com " << num_threads << " threads";
+        if (leitor.get_bytes_ignorados() > 0) std::cout << " (" << leitor.get_bytes_ignorados() << " bytes finais ignorados)";
+        std::cout << "\n\nconfigurações:\n";
+        for (auto [config, n] : a.configs) std::cout << "  " << config << ": " << n << " partidas\n";
+        std::cout << "\n";
+        if (consulta.vitorias) imprimir_vitorias(a);
+        if (consulta.vitorias && consulta.duracoes) std::cout << "\n";
+        if (consulta.duracoes) imprimir_duracoes(a);
+    } catch (const std::exception& e) {
+        std::cerr << "ConsultaResultados: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
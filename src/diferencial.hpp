@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "estatistica.hpp"
+#include "jogo.hpp"
+#include "motor_eventos.hpp"
+
+/*
+ * Teste diferencial entre o motor com threads e o motor de eventos discretos.
+ *
+ * O motor com threads não é determinístico (a ordem em que as threads chegam
+ * ao `try_acquire()` depende do escalonador), então a comparação é entre
+ * distribuições: vencedor, número de rodadas, primeiro e último eliminado e a
+ * rodada em que o primeiro e o último jogador criados caem. Cada partida com
+ * threads também passa por verificações de invariantes das regras.
+ */
+struct AmostraMotor {
+    std::vector<uint64_t> vencedores;
+    std::vector<uint64_t> rodadas;
+    std::vector<uint64_t> primeiro_eliminado;
+    std::vector<uint64_t> ultimo_eliminado;
+    std::vector<double> queda_primeiro_criado;  // rodada em que P1 saiu (n se venceu)
+    std::vector<double> queda_ultimo_criado;    // idem para Pn
+    uint64_t partidas = 0;
+    uint64_t violacoes = 0;
+
+    explicit AmostraMotor(int num_jogadores)
+        : vencedores(num_jogadores + 1, 0), rodadas(num_jogadores + 1, 0),
+          primeiro_eliminado(num_jogadores + 1, 0), ultimo_eliminado(num_jogadores + 1, 0),
+          num_jogadores(num_jogadores) {}
+
+    void registrar(const ResultadoJogo& r) {
+        ++partidas;
+        if (!valido(r)) {
+            ++violacoes;
+            return;
+        }
+        ++vencedores[r.vencedor];
+        ++rodadas[std::min<int>(r.rodadas, num_jogadores)];
+        ++primeiro_eliminado[r.ordem_eliminacao.front()];
+        ++ultimo_eliminado[r.ordem_eliminacao.back()];
+        queda_primeiro_criado.push_back(rodada_de_queda(r, 1));
+        queda_ultimo_criado.push_back(rodada_de_queda(r, num_jogadores));
+    }
+
+private:
+    // Uma partida válida tem n - 1 rodadas, cada uma eliminando um jogador
+    // distinto, e o vencedor é o único que nunca foi eliminado.
+    bool valido(const ResultadoJogo& r) const {
+        if (r.vencedor < 1 || r.vencedor > num_jogadores) return false;
+        if (r.rodadas != num_jogadores - 1) return false;
+        if (static_cast<int>(r.ordem_eliminacao.size()) != num_jogadores - 1) return false;
+        std::vector<char> visto(num_jogadores + 1, 0);
+        visto[r.vencedor] = 1;
+        for (int id : r.ordem_eliminacao) {
+            if (id < 1 || id > num_jogadores || visto[id]) return false;
+            visto[id] = 1;
+        }
+        return true;
+    }
+
+    double rodada_de_queda(const ResultadoJogo& r, int id) const {
+        for (size_t i = 0; i < r.ordem_eliminacao.size(); ++i) {
+            if (r.ordem_eliminacao[i] == id) return static_cast<double>(i + 1);
+        }
+        return num_jogadores;
+    }
+
+    int num_jogadores;
+};
+
+class HarnessDiferencial {
+public:
+    HarnessDiferencial(const ConfigJogo& config, ModeloReacao reacao, uint64_t semente)
+        : config(config), reacao(reacao), semente(semente),
+          threads(config.num_jogadores), referencia(config.num_jogadores) {}
+
+    void executar(uint64_t jogos) {
+        ConfigJogo partida = config;
+        partida.verboso = false;
+        for (uint64_t i = 0; i < jogos; ++i) {
+            partida.semente = semente + i;
+            threads.registrar(jogar_partida(partida, nullptr, &fases_threads));
+        }
+
+        MotorEventos motor(config, reacao);
+        for (uint64_t i = 0; i < jogos; ++i) {
+            referencia.registrar(motor.executar(semente + i));
+        }
+    }
+
+    // Decomposição das rodadas do motor com threads em todo o lote.
+    const RelatorioFases& get_fases() const { return fases_threads; }
+
+    // Imprime a tabela de testes e retorna true se nenhuma divergência foi
+    // significativa ao nível `alfa` e nenhuma invariante foi violada.
+    bool relatar(std::ostream& saida, double alfa) const {
+        struct Linha {
+            std::string metrica;
+            std::string teste;
+            ResultadoTeste r;
+        };
+        std::vector<Linha> linhas = {
+            {"vencedor", "qui-quadrado", qui_quadrado_duas_amostras(threads.vencedores, referencia.vencedores)},
+            {"rodadas", "qui-quadrado", qui_quadrado_duas_amostras(threads.rodadas, referencia.rodadas)},
+            {"primeiro eliminado", "qui-quadrado",
+             qui_quadrado_duas_amostras(threads.primeiro_eliminado, referencia.primeiro_eliminado)},
+            {"último eliminado", "qui-quadrado",
+             qui_quadrado_duas_amostras(threads.ultimo_eliminado, referencia.ultimo_eliminado)},
+            {"rodada de queda de P1", "KS",
+             ks_duas_amostras(threads.queda_primeiro_criado, referencia.queda_primeiro_criado)},
+            {"rodada de queda de Pn", "KS",
+             ks_duas_amostras(threads.queda_ultimo_criado, referencia.queda_ultimo_criado)},
+        };
+
+        bool aprovado = threads.violacoes == 0 && referencia.violacoes == 0;
+        saida << "Partidas: " << threads.partidas << " com threads, " << referencia.partidas << " de referência\n";
+        saida << "Violações de invariantes: " << threads.violacoes << " com threads, "
+              << referencia.violacoes << " de referência\n\n";
+        saida << coluna("métrica", 24) << coluna("teste", 14) << coluna("estatística", 13)
+              << coluna("gl", 6) << "p-valor\n";
+        for (const Linha& l : linhas) {
+            bool diverge = l.r.p_valor < alfa;
+            aprovado = aprovado && !diverge;
+            saida << coluna(l.metrica, 24) << coluna(l.teste, 14)
+                  << std::left << std::setw(13) << std::setprecision(4) << l.r.estatistica
+                  << std::setw(6) << l.r.graus_liberdade << std::setprecision(4) << l.r.p_valor
+                  << (diverge ? "  <-- diverge" : "") << "\n";
+        }
+        saida << "\nvitórias / primeiro eliminado por jogador (threads | referência):\n";
+        for (size_t id = 1; id < threads.vencedores.size() && id <= 16; ++id) {
+            saida << "  P" << id << ": " << threads.vencedores[id] << " / " << threads.primeiro_eliminado[id]
+                  << " | " << referencia.vencedores[id] << " / " << referencia.primeiro_eliminado[id] << "\n";
+        }
+        saida << "\n" << (aprovado ? "Distribuições compatíveis" : "DIVERGÊNCIA detectada")
+              << " (alfa = " << alfa << ")\n";
+        return aprovado;
+    }
+
+private:
+    ConfigJogo config;
+    ModeloReacao reacao;
+    uint64_t semente;
+    AmostraMotor threads;
+    AmostraMotor referencia;
+    RelatorioFases fases_threads;
+};
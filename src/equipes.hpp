@@ -0,0 +1,286 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "aleatorio.hpp"
+#include "permissoes.hpp"
+
+// Parâmetros de uma partida por equipes.
+struct ConfigEquipes {
+    int equipes = 4;
+    int tamanho = 2;  // jogadores por equipe = cadeiras que a equipe precisa
+    int musica_min_ms = 5;
+    int musica_max_ms = 20;
+    int espera_sentar_ms = 500;
+    uint64_t semente = 0;  // 0 sorteia uma semente nova
+    bool verboso = true;
+};
+
+struct ResultadoEquipes {
+    int vencedora = -1;
+    int rodadas = 0;
+    std::vector<int> ordem_eliminacao;
+    uint64_t violacoes = 0;  // rodadas em que as cadeiras ocupadas não fecharam com as equipes sentadas
+};
+
+/*
+ * Variante por equipes: cada equipe tem `tamanho` jogadores, cada um com a
+ * sua thread, e só senta se conseguir `tamanho` cadeiras juntas. Cada rodada
+ * tem `(equipes ativas - 1) * tamanho` cadeiras. Quando a música para, o
+ * primeiro membro da equipe a reagir tenta pela equipe inteira, com um
+ * `tentar_pegar(tamanho)` tudo ou nada em PermissoesAtomicas. Entre as
+ * equipes que ficaram sem cadeiras, uma é eliminada por sorteio.
+ */
+class JogoEquipes {
+public:
+    explicit JogoEquipes(const ConfigEquipes& config)
+        : config(config), gen(config.semente ? config.semente : std::random_device{}()),
+          eliminada(config.equipes, 0), reivindicada(std::make_unique<std::atomic<int>[]>(config.equipes)) {}
+
+    ResultadoEquipes jogar() {
+        std::vector<std::thread> membros;
+        for (int e = 0; e < config.equipes; ++e) {
+            for (int m = 0; m < config.tamanho; ++m) membros.emplace_back(&JogoEquipes::membro, this, e);
+        }
+        std::vector<int> ativas(config.equipes);
+        for (int e = 0; e < config.equipes; ++e) ativas[e] = e;
+
+        while (ativas.size() > 1) {
+            const int64_t cadeiras = static_cast<int64_t>(ativas.size() - 1) * config.tamanho;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                permissoes.redefinir(cadeiras);
+                ++epoca_permissoes;
+                sentadas.clear();
+                tentativas = 0;
+            }
+            if (config.verboso) {
+                std::cout << "\nRodada com " << ativas.size() << " equipes de " << config.tamanho << " e " << cadeiras
+                          << " cadeiras. A música está tocando... 🎵\n";
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(gen.entre(config.musica_min_ms, config.musica_max_ms)));
+
+            auto prazo = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.espera_sentar_ms);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                musica_parada = true;
+                ++rodada;
+                rodada_aberta.store(rodada, std::memory_order_release);
+            }
+            musica_cv.notify_all();
+
+            std::vector<int> sentadas_rodada;
+            bool todas;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                todas = tentativas_cv.wait_until(lock, prazo,
+                                                 [&] { return tentativas >= static_cast<int>(ativas.size()); });
+                rodada_aberta.store(0, std::memory_order_relaxed);
+                musica_parada = false;
+                sentadas_rodada = sentadas;
+            }
+            // Fechada pelo prazo, um atrasado pode estar entre o CAS e a devolução.
+            const int64_t ocupadas = static_cast<int64_t>(sentadas_rodada.size()) * config.tamanho;
+            if (todas && permissoes.disponiveis() != cadeiras - ocupadas) ++resultado.violacoes;
+
+            std::vector<int> sem_cadeira;
+            for (int e : ativas) {
+                if (std::find(sentadas_rodada.begin(), sentadas_rodada.end(), e) == sentadas_rodada.end()) {
+                    sem_cadeira.push_back(e);
+                }
+            }
+            if (sem_cadeira.empty()) {
+                // Todas sentaram: havia mais permissões do que cadeiras. Não
+                // há quem eliminar; a rodada conta como violação e se repete.
+                ++resultado.violacoes;
+                ++resultado.rodadas;
+                continue;
+            }
+            int eliminada_id = sem_cadeira[gen.abaixo(static_cast<uint32_t>(sem_cadeira.size()))];
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                eliminada[eliminada_id] = 1;
+            }
+            musica_cv.notify_all();
+            ativas.erase(std::find(ativas.begin(), ativas.end(), eliminada_id));
+            resultado.ordem_eliminacao.push_back(eliminada_id + 1);
+            ++resultado.rodadas;
+            if (config.verboso) {
+                for (size_t i = 0; i < sentadas_rodada.size(); ++i) {
+                    std::cout << "[Cadeiras " << i * config.tamanho + 1 << "-" << (i + 1) * config.tamanho
+                              << "]: Equipe E" << sentadas_rodada[i] + 1 << "\n";
+                }
+                std::cout << "Equipe E" << eliminada_id + 1 << " ficou sem cadeiras e foi eliminada!\n";
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ativo = false;
+        }
+        musica_cv.notify_all();
+        for (auto& t : membros) t.join();
+        resultado.vencedora = ativas.front() + 1;
+        if (config.verboso) std::cout << "\n🏆 Vencedora: Equipe E" << resultado.vencedora << "! 🏆\n";
+        return resultado;
+    }
+
+private:
+    void membro(int equipe) {
+        int rodada_vista = 0;
+        uint64_t epoca_vista = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                musica_cv.wait(lock, [&] {
+                    return !ativo || eliminada[equipe] || (musica_parada && rodada > rodada_vista);
+                });
+                if (!ativo || eliminada[equipe]) return;
+                rodada_vista = rodada;
+                epoca_vista = epoca_permissoes;
+            }
+            // Só o primeiro membro a reagir tenta; os outros já estão representados.
+            if (reivindicada[equipe].exchange(rodada_vista, std::memory_order_relaxed) == rodada_vista) continue;
+
+            bool sentou = rodada_aberta.load(std::memory_order_acquire) == rodada_vista &&
+                          permissoes.tentar_pegar(config.tamanho);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (rodada_aberta.load(std::memory_order_relaxed) != rodada_vista) {
+                    // O prazo venceu no meio do caminho. A rodada seguinte pode já
+                    // ter zerado `tentativas`; contar aqui a fecharia antes de uma
+                    // equipe viva tentar. As permissões só voltam se o conjunto não
+                    // foi redefinido desde o CAS: depois disso elas já saíram da
+                    // conta e sobrariam na rodada seguinte.
+                    if (sentou && epoca_permissoes == epoca_vista) permissoes.devolver(config.tamanho);
+                    continue;
+                }
+                if (sentou) sentadas.push_back(equipe);
+                ++tentativas;
+            }
+            tentativas_cv.notify_one();
+        }
+    }
+
+    ConfigEquipes config;
+    GeradorLote gen;  // só o coordenador usa
+    ResultadoEquipes resultado;
+    PermissoesAtomicas permissoes;
+
+    std::mutex mutex;
+    std::condition_variable musica_cv;
+    std::condition_variable tentativas_cv;
+    bool ativo = true;
+    bool musica_parada = false;
+    int rodada = 0;
+    int tentativas = 0;              // equipes que tentaram nesta rodada
+    uint64_t epoca_permissoes = 0;   // redefinições de `permissoes`
+    std::vector<int> sentadas;       // equipes, na ordem em que sentaram
+    std::vector<char> eliminada;     // por equipe
+    std::atomic<int> rodada_aberta{0};
+    std::unique_ptr<std::atomic<int>[]> reivindicada;  // última rodada em que a equipe tentou
+};
+
+/*
+ * Bancada de disputa por várias permissões: `threads` threads disputam um
+ * conjunto de permissões que só comporta metade delas ao mesmo tempo, cada
+ * uma pegando `k` de uma vez e devolvendo logo em seguida.
+ *
+ * - cas: `PermissoesAtomicas::tentar_pegar(k)`, tudo ou nada;
+ * - semaforo: k `try_acquire()` num `std::counting_semaphore`, devolvendo o
+ *   que foi pego quando não completa as k (posse parcial desfeita).
+ *
+ * Com k = 1 as duas são a posse de uma cadeira só, a referência.
+ */
+enum class EstrategiaPosse { Cas, Semaforo };
+
+inline const char* nome_estrategia(EstrategiaPosse e) { return e == EstrategiaPosse::Cas ? "cas" : "semaforo"; }
+
+struct MedicaoPosse {
+    EstrategiaPosse estrategia = EstrategiaPosse::Cas;
+    int threads = 1;
+    int k = 1;
+    double segundos = 0;
+    uint64_t posses = 0;
+    uint64_t falhas = 0;
+    uint64_t desfeitas = 0;           // posses parciais devolvidas (só no semáforo)
+    uint64_t menor_por_thread = 0;    // posses da thread com menos sucesso
+    uint64_t maior_por_thread = 0;
+};
+
+inline MedicaoPosse medir_posse(EstrategiaPosse estrategia, int threads, int k, double segundos) {
+    const int64_t capacidade = std::max<int64_t>(k, static_cast<int64_t>(threads) * k / 2);
+    PermissoesAtomicas atomicas(capacidade);
+    std::counting_semaphore<> semaforo(capacidade);
+
+    struct alignas(64) Contagem {
+        uint64_t posses = 0, falhas = 0, desfeitas = 0;
+    };
+    std::vector<Contagem> contagens(threads);
+    std::atomic<bool> largada{false}, ativo{true};
+    std::vector<std::thread> ts;
+    for (int t = 0; t < threads; ++t) {
+        ts.emplace_back([&, t] {
+            Contagem c;
+            while (!largada.load(std::memory_order_acquire)) std::this_thread::yield();
+            while (ativo.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < 256; ++i) {
+                    if (estrategia == EstrategiaPosse::Cas) {
+                        if (atomicas.tentar_pegar(k)) {
+                            ++c.posses;
+                            atomicas.devolver(k);
+                        } else {
+                            ++c.falhas;
+                        }
+                        continue;
+                    }
+                    int pegou = 0;
+                    while (pegou < k && semaforo.try_acquire()) ++pegou;
+                    if (pegou == k) {
+                        ++c.posses;
+                        semaforo.release(k);
+                    } else {
+                        ++c.falhas;
+                        if (pegou > 0) {
+                            ++c.desfeitas;
+                            semaforo.release(pegou);
+                        }
+                    }
+                }
+            }
+            contagens[t] = c;
+        });
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+    largada.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(segundos));
+    ativo.store(false, std::memory_order_relaxed);
+    for (auto& t : ts) t.join();
+
+    MedicaoPosse m;
+    m.estrategia = estrategia;
+    m.threads = threads;
+    m.k = k;
+    m.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    m.menor_por_thread = ~0ull;
+    for (const Contagem& c : contagens) {
+        m.posses += c.posses;
+        m.falhas += c.falhas;
+        m.desfeitas += c.desfeitas;
+        m.menor_por_thread = std::min(m.menor_por_thread, c.posses);
+        m.maior_por_thread = std::max(m.maior_por_thread, c.posses);
+    }
+    return m;
+}
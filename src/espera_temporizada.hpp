@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "histograma.hpp"
+#include "permissoes.hpp"
+
+/*
+ * Bancada do caminho com prazo: `std::counting_semaphore::try_acquire_until`
+ * contra `PermissoesAtomicas::tentar_pegar_ate`, em três cenários:
+ *
+ * - imediata: há permissão livre; custo de uma espera com prazo que não
+ *   precisa esperar, mais a devolução;
+ * - expira: nunca há permissão; quanto a volta passa do prazo pedido;
+ *   mede a precisão do timeout;
+ * - entrega: várias threads esperam com prazo e outra devolve uma permissão
+ *   a intervalos fixos; latência da devolução até alguém sair da espera.
+ */
+struct AdaptadorSemaforo {
+    static constexpr const char* nome = "semaforo";
+    std::counting_semaphore<> semaforo{0};
+    bool pegar_ate(std::chrono::steady_clock::time_point limite) { return semaforo.try_acquire_until(limite); }
+    void devolver() { semaforo.release(); }
+};
+
+struct AdaptadorAtomicas {
+    static constexpr const char* nome = "atomicas";
+    PermissoesAtomicas permissoes{0};
+    bool pegar_ate(std::chrono::steady_clock::time_point limite) { return permissoes.tentar_pegar_ate(1, limite); }
+    void devolver() { permissoes.devolver(1); }
+};
+
+struct MedicaoEspera {
+    std::string primitiva;
+    std::string cenario;
+    uint64_t operacoes = 0;
+    double ns_por_operacao = 0;
+    uint64_t expiradas = 0;  // esperas que voltaram sem permissão
+    Histograma atraso_ns;    // expira: além do prazo; entrega: da devolução até a saída da espera
+};
+
+template <typename Adaptador>
+MedicaoEspera medir_espera_imediata(uint64_t operacoes) {
+    Adaptador a;
+    a.devolver();
+    MedicaoEspera m;
+    m.primitiva = Adaptador::nome;
+    m.cenario = "imediata";
+    auto inicio = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < operacoes; ++i) {
+        if (!a.pegar_ate(std::chrono::steady_clock::now() + std::chrono::milliseconds(1))) ++m.expiradas;
+        a.devolver();
+    }
+    auto total = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+    m.operacoes = operacoes;
+    m.ns_por_operacao = total / static_cast<double>(std::max<uint64_t>(1, operacoes));
+    return m;
+}
+
+template <typename Adaptador>
+MedicaoEspera medir_espera_expira(uint64_t operacoes, std::chrono::microseconds prazo) {
+    Adaptador a;
+    MedicaoEspera m;
+    m.primitiva = Adaptador::nome;
+    m.cenario = "expira";
+    for (uint64_t i = 0; i < operacoes; ++i) {
+        auto inicio = std::chrono::steady_clock::now();
+        auto limite = inicio + prazo;
+        if (a.pegar_ate(limite)) continue;
+        auto fim = std::chrono::steady_clock::now();
+        ++m.expiradas;
+        m.atraso_ns.registrar(static_cast<uint64_t>(std::max<int64_t>(0, (fim - limite).count())));
+        m.ns_por_operacao += std::chrono::duration<double, std::nano>(fim - inicio).count();
+    }
+    m.operacoes = operacoes;
+    m.ns_por_operacao /= static_cast<double>(std::max<uint64_t>(1, m.expiradas));
+    return m;
+}
+
+template <typename Adaptador>
+MedicaoEspera medir_espera_entrega(int esperando, std::chrono::microseconds intervalo, double segundos) {
+    Adaptador a;
+    MedicaoEspera m;
+    m.primitiva = Adaptador::nome;
+    m.cenario = "entrega";
+    std::atomic<int64_t> devolvida_ns{0};
+    std::atomic<bool> ativo{true};
+    std::mutex mutex;
+    auto agora_ns = [] {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < esperando; ++t) {
+        threads.emplace_back([&] {
+            Histograma local;
+            uint64_t expiradas = 0;
+            while (ativo.load(std::memory_order_relaxed)) {
+                if (a.pegar_ate(std::chrono::steady_clock::now() + std::chrono::milliseconds(20))) {
+                    if (!ativo.load(std::memory_order_relaxed)) break;  // devolução de encerramento
+                    local.registrar(static_cast<uint64_t>(
+                        std::max<int64_t>(0, agora_ns() - devolvida_ns.load(std::memory_order_acquire))));
+                } else {
+                    ++expiradas;
+                }
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            m.atraso_ns.somar(local);
+            m.expiradas += expiradas;
+        });
+    }
+
+    auto fim = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                      std::chrono::duration<double>(segundos));
+    auto proxima = std::chrono::steady_clock::now() + intervalo;
+    while (proxima < fim) {
+        std::this_thread::sleep_until(proxima);
+        devolvida_ns.store(agora_ns(), std::memory_order_release);
+        a.devolver();
+        ++m.operacoes;
+        proxima += intervalo;
+    }
+    ativo.store(false, std::memory_order_relaxed);
+    for (int t = 0; t < esperando; ++t) a.devolver();  // acorda quem ainda espera
+    for (auto& t : threads) t.join();
+    return m;
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Testes de hipótese usados para comparar distribuições produzidas pelos motores.
+
+// Célula de texto dos relatórios dos testes, alinhada pela quantidade de
+// caracteres UTF-8, não de bytes; sempre sobra ao menos um espaço.
+inline std::string coluna(const std::string& texto, size_t largura) {
+    size_t caracteres = 0;
+    for (unsigned char c : texto) caracteres += (c & 0xC0) != 0x80;
+    return texto + std::string(largura > caracteres ? largura - caracteres : 1, ' ');
+}
+
+struct ResultadoTeste {
+    double estatistica = 0.0;
+    double graus_liberdade = 0.0;
+    double p_valor = 1.0;
+};
+
+// Função gama incompleta regularizada superior Q(a, x) = Γ(a, x) / Γ(a).
+inline double gama_incompleta_q(double a, double x) {
+    if (x <= 0.0) return 1.0;
+    const double lg = std::lgamma(a);
+    if (x < a + 1.0) {
+        // Série para P(a, x).
+        double soma = 1.0 / a, termo = soma, ap = a;
+        for (int n = 0; n < 1000; ++n) {
+            ap += 1.0;
+            termo *= x / ap;
+            soma += termo;
+            if (std::fabs(termo) < std::fabs(soma) * 1e-15) break;
+        }
+        return 1.0 - soma * std::exp(-x + a * std::log(x) - lg);
+    }
+    // Fração contínua de Lentz para Q(a, x).
+    const double minusculo = 1e-300;
+    double b = x + 1.0 - a, c = 1.0 / minusculo, d = 1.0 / b, h = d;
+    for (int i = 1; i < 1000; ++i) {
+        double an = -i * (i - a);
+        b += 2.0;
+        d = an * d + b;
+        if (std::fabs(d) < minusculo) d = minusculo;
+        c = b + an / c;
+        if (std::fabs(c) < minusculo) c = minusculo;
+        d = 1.0 / d;
+        double delta = d * c;
+        h *= delta;
+        if (std::fabs(delta - 1.0) < 1e-15) break;
+    }
+    return std::exp(-x + a * std::log(x) - lg) * h;
+}
+
+// Qui-quadrado de homogeneidade entre dois histogramas com as mesmas classes.
+// Classes vazias nas duas amostras são ignoradas.
+inline ResultadoTeste qui_quadrado_duas_amostras(const std::vector<uint64_t>& a, const std::vector<uint64_t>& b) {
+    double total_a = 0, total_b = 0;
+    for (size_t i = 0; i < a.size(); ++i) total_a += a[i];
+    for (size_t i = 0; i < b.size(); ++i) total_b += b[i];
+
+    ResultadoTeste r;
+    if (total_a == 0 || total_b == 0) return r;
+    const double ka = std::sqrt(total_b / total_a), kb = std::sqrt(total_a / total_b);
+    int classes = 0;
+    for (size_t i = 0; i < std::max(a.size(), b.size()); ++i) {
+        double oa = i < a.size() ? static_cast<double>(a[i]) : 0.0;
+        double ob = i < b.size() ? static_cast<double>(b[i]) : 0.0;
+        if (oa + ob == 0) continue;
+        double diff = oa * ka - ob * kb;
+        r.estatistica += diff * diff / (oa + ob);
+        ++classes;
+    }
+    r.graus_liberdade = classes - 1;
+    r.p_valor = r.graus_liberdade > 0 ? gama_incompleta_q(r.graus_liberdade / 2.0, r.estatistica / 2.0) : 1.0;
+    return r;
+}
+
+// Kolmogorov-Smirnov de duas amostras; `estatistica` é o D máximo entre as
+// distribuições empíricas e o p-valor usa a aproximação assintótica.
+inline ResultadoTeste ks_duas_amostras(std::vector<double> a, std::vector<double> b) {
+    ResultadoTeste r;
+    if (a.empty() || b.empty()) return r;
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+
+    const double na = a.size(), nb = b.size();
+    size_t i = 0, j = 0;
+    double d = 0.0;
+    while (i < a.size() && j < b.size()) {
+        double x = std::min(a[i], b[j]);
+        while (i < a.size() && a[i] <= x) ++i;
+        while (j < b.size() && b[j] <= x) ++j;
+        d = std::max(d, std::fabs(i / na - j / nb));
+    }
+    r.estatistica = d;
+
+    const double en = std::sqrt(na * nb / (na + nb));
+    const double lambda = (en + 0.12 + 0.11 / en) * d;
+    double soma = 0.0, sinal = 1.0;
+    for (int k = 1; k <= 100; ++k) {
+        double termo = sinal * std::exp(-2.0 * k * k * lambda * lambda);
+        soma += termo;
+        if (std::fabs(termo) < 1e-12) break;
+        sinal = -sinal;
+    }
+    r.p_valor = std::clamp(2.0 * soma, 0.0, 1.0);
+    if (lambda < 1e-3) r.p_valor = 1.0;
+    return r;
+}
+
+// Qui-quadrado de aderência à distribuição uniforme sobre as classes a partir
+// de `inicio` (por exemplo, vitórias por jogador, com o índice 0 sem uso).
+inline ResultadoTeste qui_quadrado_uniforme(const std::vector<uint64_t>& contagens, size_t inicio = 0) {
+    ResultadoTeste r;
+    if (contagens.size() <= inicio + 1) return r;
+    double total = 0;
+    for (size_t i = inicio; i < contagens.size(); ++i) total += contagens[i];
+    if (total == 0) return r;
+    const double esperado = total / static_cast<double>(contagens.size() - inicio);
+    for (size_t i = inicio; i < contagens.size(); ++i) {
+        double diff = static_cast<double>(contagens[i]) - esperado;
+        r.estatistica += diff * diff / esperado;
+    }
+    r.graus_liberdade = static_cast<double>(contagens.size() - inicio - 1);
+    r.p_valor = gama_incompleta_q(r.graus_liberdade / 2.0, r.estatistica / 2.0);
+    return r;
+}
+
+// Qui-quadrado de homogeneidade de proporções: `sucessos[i]` em `totais[i]`
+// tentativas por classe, a partir de `inicio`, contra a taxa conjunta.
+// Classes sem tentativas são ignoradas.
+inline ResultadoTeste qui_quadrado_proporcoes(const std::vector<uint64_t>& sucessos,
+                                              const std::vector<uint64_t>& totais, size_t inicio = 0) {
+    ResultadoTeste r;
+    double s = 0, t = 0;
+    for (size_t i = inicio; i < totais.size(); ++i) {
+        s += sucessos[i];
+        t += totais[i];
+    }
+    if (t == 0 || s == 0 || s == t) return r;
+    const double p = s / t;
+    int classes = 0;
+    for (size_t i = inicio; i < totais.size(); ++i) {
+        if (totais[i] == 0) continue;
+        double esperado = totais[i] * p;
+        double diff = static_cast<double>(sucessos[i]) - esperado;
+        r.estatistica += diff * diff / (esperado * (1.0 - p));
+        ++classes;
+    }
+    r.graus_liberdade = classes - 1;
+    r.p_valor = r.graus_liberdade > 0 ? gama_incompleta_q(r.graus_liberdade / 2.0, r.estatistica / 2.0) : 1.0;
+    return r;
+}
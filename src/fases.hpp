@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+#include "histograma.hpp"
+
+/*
+ * Decomposição de cada rodada do jogo com threads em fases cronometradas, em
+ * nanossegundos:
+ *
+ *   musica            música tocando (sono do coordenador)
+ *   primeiro_assento  da música parar até a primeira cadeira ocupada
+ *   ultima_tentativa  da música parar até a última tentativa de sentar
+ *   resolucao         sorteio e eliminação em `liberar_threads_eliminadas`
+ *   exibicao          impressão do resultado da rodada
+ *   ressincronizacao  reajuste das permissões do semáforo em `iniciar_rodada`
+ *
+ * Além das fases, cada rodada tem a duração total, do início da rodada até
+ * as cadeiras voltarem. `RelatorioFases` agrega as rodadas em histogramas;
+ * somando relatórios de várias partidas se obtém a tabela do lote.
+ */
+enum Fase : int {
+    Musica,
+    PrimeiroAssento,
+    UltimaTentativa,
+    Resolucao,
+    Exibicao,
+    Ressincronizacao,
+    NUM_FASES,
+};
+
+inline const char* nome_fase(int fase) {
+    static const char* const nomes[NUM_FASES] = {"musica",    "primeiro_assento", "ultima_tentativa",
+                                                 "resolucao", "exibicao",         "ressincronizacao"};
+    return nomes[fase];
+}
+
+// Uma rodada; fases que não aconteceram (ninguém sentou, por exemplo) ficam
+// com NAO_MEDIDA e não entram no relatório.
+struct TemposFases {
+    static constexpr uint64_t NAO_MEDIDA = ~0ull;
+    uint64_t ns[NUM_FASES] = {NAO_MEDIDA, NAO_MEDIDA, NAO_MEDIDA, NAO_MEDIDA, NAO_MEDIDA, NAO_MEDIDA};
+    uint64_t total_ns = NAO_MEDIDA;
+};
+
+class RelatorioFases {
+public:
+    void registrar(const TemposFases& t) {
+        for (int f = 0; f < NUM_FASES; ++f) {
+            if (t.ns[f] != TemposFases::NAO_MEDIDA) fases[f].registrar(t.ns[f]);
+        }
+        if (t.total_ns != TemposFases::NAO_MEDIDA) total.registrar(t.total_ns);
+        ++rodadas;
+    }
+
+    void somar(const RelatorioFases& outro) {
+        for (int f = 0; f < NUM_FASES; ++f) fases[f].somar(outro.fases[f]);
+        total.somar(outro.total);
+        rodadas += outro.rodadas;
+    }
+
+    uint64_t get_rodadas() const { return rodadas; }
+    const Histograma& get_fase(int fase) const { return fases[fase]; }
+    const Histograma& get_total() const { return total; }
+
+    // Tabela de percentis em µs, uma linha por fase.
+    void imprimir(std::ostream& saida, const std::string& titulo) const {
+        const auto formato = saida.flags();
+        const auto precisao = saida.precision();
+        saida << titulo << " (" << rodadas << " rodadas, µs)\n";
+        saida << std::left << std::setw(18) << "fase" << std::right << std::setw(9) << "amostras" << std::setw(11)
+              << "p50" << std::setw(11) << "p90" << std::setw(11) << "p99" << std::setw(11) << "máx" << "\n";
+        auto linha = [&](const char* nome, const Histograma& h) {
+            saida << std::left << std::setw(18) << nome << std::right << std::setw(9) << h.get_total();
+            for (double q : {0.5, 0.9, 0.99, 1.0}) {
+                saida << std::setw(11) << std::fixed << std::setprecision(1) << h.quantil(q) / 1000.0;
+            }
+            saida << "\n";
+        };
+        for (int f = 0; f < NUM_FASES; ++f) linha(nome_fase(f), fases[f]);
+        linha("rodada (total)", total);
+        saida.flags(formato);
+        saida.precision(precisao);
+    }
+
+private:
+    Histograma fases[NUM_FASES];
+    Histograma total;
+    uint64_t rodadas = 0;
+};
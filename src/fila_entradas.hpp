@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+/*
+ * Fila de entrada de jogadores com a partida em andamento: vários produtores
+ * (quem chega) e um consumidor (o coordenador, em `iniciar_rodada`).
+ *
+ * Os ids de quem pode entrar formam uma faixa fixa, com um nó pré-alocado
+ * por id. `entrar()` reserva o próximo id com um `fetch_add` e empilha o nó
+ * dele com CAS (pilha de Treiber); nenhum produtor espera pelo outro nem
+ * pelo coordenador. `drenar()` tira a pilha inteira com um `exchange` e a
+ * percorre na ordem de chegada. Como cada nó é usado uma única vez e só o
+ * consumidor desempilha, não há ABA nem reciclagem de memória para tratar.
+ */
+class FilaEntradas {
+public:
+    // Ids de `primeiro_id` a `ultimo_id`, inclusive; faixa vazia se ultimo < primeiro.
+    FilaEntradas(int primeiro_id, int ultimo_id)
+        : primeiro_id(primeiro_id), ultimo_id(ultimo_id), proximo_id(primeiro_id),
+          nos(std::make_unique<No[]>(ultimo_id >= primeiro_id ? ultimo_id - primeiro_id + 1 : 0)) {}
+
+    // Reserva um id e o publica na fila. Retorna 0 se a faixa acabou.
+    int entrar() {
+        if (proximo_id.load(std::memory_order_relaxed) > ultimo_id) return 0;  // não estoura o contador
+        int id = proximo_id.fetch_add(1, std::memory_order_relaxed);
+        if (id > ultimo_id) return 0;
+        No* no = &nos[id - primeiro_id];
+        no->id = id;
+        No* topo_atual = topo.load(std::memory_order_relaxed);
+        do {
+            no->proximo = topo_atual;
+        } while (!topo.compare_exchange_weak(topo_atual, no, std::memory_order_release, std::memory_order_relaxed));
+        return id;
+    }
+
+    bool vazia() const { return topo.load(std::memory_order_acquire) == nullptr; }
+
+    // Só o consumidor chama. Entrega a `admitir(id)` tudo que foi publicado
+    // até aqui, na ordem de chegada, e retorna quantos foram.
+    template <typename F>
+    int drenar(F&& admitir) {
+        No* lista = topo.exchange(nullptr, std::memory_order_acquire);
+        No* invertida = nullptr;
+        while (lista) {
+            No* proximo = lista->proximo;
+            lista->proximo = invertida;
+            invertida = lista;
+            lista = proximo;
+        }
+        int n = 0;
+        for (; invertida; invertida = invertida->proximo, ++n) admitir(invertida->id);
+        return n;
+    }
+
+    int get_ultimo_id() const { return ultimo_id; }
+
+private:
+    struct No {
+        int id = 0;
+        No* proximo = nullptr;
+    };
+
+    int primeiro_id;
+    int ultimo_id;
+    std::atomic<int> proximo_id;
+    std::unique_ptr<No[]> nos;
+    std::atomic<No*> topo{nullptr};
+};
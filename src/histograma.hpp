@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Histograma log-linear: 64 classes por potência de 2, erro relativo < 1,6%.
+class Histograma {
+public:
+    static constexpr int SUBCLASSES = 64;
+
+    void registrar(uint64_t valor) {
+        ++contagens[classe(valor)];
+        ++total;
+    }
+
+    void somar(const Histograma& outro) {
+        for (size_t i = 0; i < contagens.size(); ++i) contagens[i] += outro.contagens[i];
+        total += outro.total;
+    }
+
+    // Limite inferior da classe que contém o quantil `q`.
+    uint64_t quantil(double q) const {
+        if (total == 0) return 0;
+        uint64_t alvo = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+        uint64_t acumulado = 0;
+        for (size_t i = 0; i < contagens.size(); ++i) {
+            acumulado += contagens[i];
+            if (acumulado > alvo) return inicio_classe(i);
+        }
+        return inicio_classe(contagens.size() - 1);
+    }
+
+    uint64_t get_total() const { return total; }
+
+private:
+    static size_t classe(uint64_t valor) {
+        if (valor < 2 * SUBCLASSES) return static_cast<size_t>(valor);
+        int expoente = 63 - __builtin_clzll(valor) - 6;  // valor >> expoente fica em [64, 128)
+        return static_cast<size_t>(expoente) * SUBCLASSES + static_cast<size_t>(valor >> expoente);
+    }
+
+    static uint64_t inicio_classe(size_t indice) {
+        if (indice < 2 * SUBCLASSES) return indice;
+        size_t expoente = indice / SUBCLASSES - 1;
+        return static_cast<uint64_t>(indice - expoente * SUBCLASSES) << expoente;
+    }
+
+    std::vector<uint64_t> contagens = std::vector<uint64_t>(60 * SUBCLASSES, 0);
+    uint64_t total = 0;
+};
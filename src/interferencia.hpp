@@ -0,0 +1,252 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <ostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "diferencial.hpp"
+#include "estatistica.hpp"
+#include "fases.hpp"
+#include "jogo.hpp"
+
+/*
+ * Vizinhos barulhentos: threads de fundo que disputam recursos com o jogo
+ * enquanto as partidas rodam.
+ *
+ * - cpu: laço aritmético que nunca dorme, disputando núcleos com as threads
+ *   dos jogadores e do coordenador (latência de acordar);
+ * - memoria: escreve e lê em sequência um buffer bem maior que a cache,
+ *   saturando a banda de memória;
+ * - cache: passeio aleatório e dependente sobre um buffer do tamanho de duas
+ *   caches de último nível, sujando cada linha visitada, para expulsar o que
+ *   o jogo tiver em cache.
+ *
+ * As threads param juntas em `encerrar()` (ou no destrutor). Depois disso,
+ * `get_trabalho()` conta as iterações de todas elas, para conferir que a
+ * interferência de fato rodou.
+ */
+struct ConfigInterferencia {
+    int cpu = 0;
+    int memoria = 0;
+    int cache = 0;
+    size_t memoria_mb = 256;  // buffer de cada thread de memória
+    size_t cache_kb = 0;      // buffer de cada thread de cache; 0 = 2x a cache de último nível
+
+    bool vazia() const { return cpu + memoria + cache == 0; }
+
+    std::string descrever() const {
+        return std::to_string(cpu) + " cpu, " + std::to_string(memoria) + " memória (" +
+               std::to_string(memoria_mb) + " MB), " + std::to_string(cache) + " cache (" +
+               std::to_string(tamanho_cache() / 1024) + " KB)";
+    }
+
+    size_t tamanho_cache() const {
+        if (cache_kb > 0) return cache_kb * 1024;
+        long llc = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+        if (llc <= 0) llc = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (llc <= 0) llc = 8 << 20;
+        return std::min<size_t>(2 * static_cast<size_t>(llc), size_t(512) << 20);
+    }
+};
+
+class GeradorInterferencia {
+public:
+    explicit GeradorInterferencia(const ConfigInterferencia& config) {
+        for (int i = 0; i < config.cpu; ++i) threads.emplace_back([this, i] { queimar_cpu(i); });
+        for (int i = 0; i < config.memoria; ++i) {
+            threads.emplace_back([this, bytes = config.memoria_mb << 20] { consumir_banda(bytes); });
+        }
+        for (int i = 0; i < config.cache; ++i) {
+            threads.emplace_back([this, i, bytes = config.tamanho_cache()] { sujar_cache(bytes, i); });
+        }
+    }
+
+    ~GeradorInterferencia() { encerrar(); }
+
+    void encerrar() {
+        parar.store(true, std::memory_order_relaxed);
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+
+    GeradorInterferencia(const GeradorInterferencia&) = delete;
+    GeradorInterferencia& operator=(const GeradorInterferencia&) = delete;
+
+    uint64_t get_trabalho() const { return trabalho.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t LINHA = 64;
+
+    void queimar_cpu(int semente) {
+        uint64_t x = 0x9E3779B97F4A7C15ull * (semente + 1), iteracoes = 0;
+        while (!parar.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 4096; ++i) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+            }
+            ++iteracoes;
+        }
+        asm volatile("" : : "r"(x));
+        trabalho.fetch_add(iteracoes, std::memory_order_relaxed);
+    }
+
+    // Alterna uma passada de escrita e uma de leitura, 1 MB por vez.
+    void consumir_banda(size_t bytes) {
+        std::unique_ptr<uint64_t[]> buffer(new uint64_t[bytes / 8]);
+        const size_t palavras = bytes / 8, bloco = (1 << 20) / 8;
+        uint64_t soma = 0, iteracoes = 0, valor = 1;
+        while (!parar.load(std::memory_order_relaxed)) {
+            for (size_t inicio = 0; inicio < palavras && !parar.load(std::memory_order_relaxed); inicio += bloco) {
+                size_t fim = std::min(palavras, inicio + bloco);
+                std::fill(buffer.get() + inicio, buffer.get() + fim, valor);
+            }
+            for (size_t inicio = 0; inicio < palavras && !parar.load(std::memory_order_relaxed); inicio += bloco) {
+                size_t fim = std::min(palavras, inicio + bloco);
+                soma = std::accumulate(buffer.get() + inicio, buffer.get() + fim, soma);
+            }
+            ++valor;
+            ++iteracoes;
+        }
+        asm volatile("" : : "r"(soma));
+        trabalho.fetch_add(iteracoes, std::memory_order_relaxed);
+    }
+
+    // Cada linha guarda o índice da próxima num ciclo aleatório; a carga
+    // seguinte depende da anterior, então o prefetcher não ajuda.
+    void sujar_cache(size_t bytes, int semente) {
+        const size_t linhas = std::max<size_t>(bytes / LINHA, 2);
+        std::vector<uint32_t> ordem(linhas);
+        std::iota(ordem.begin(), ordem.end(), 0u);
+        std::shuffle(ordem.begin(), ordem.end(), std::mt19937_64(semente + 1));
+
+        struct alignas(LINHA) Linha {
+            uint32_t proxima;
+            uint32_t sujeira;
+        };
+        std::unique_ptr<Linha[]> buffer(new Linha[linhas]);
+        for (size_t i = 0; i < linhas; ++i) buffer[ordem[i]] = {ordem[(i + 1) % linhas], 0};
+
+        uint32_t atual = ordem[0];
+        uint64_t iteracoes = 0;
+        while (!parar.load(std::memory_order_relaxed)) {
+            for (int i = 0; i < 1024; ++i) {
+                Linha& l = buffer[atual];
+                ++l.sujeira;
+                atual = l.proxima;
+            }
+            ++iteracoes;
+        }
+        trabalho.fetch_add(iteracoes, std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> parar{false};
+    std::atomic<uint64_t> trabalho{0};
+    std::vector<std::thread> threads;
+};
+
+/*
+ * Roda o mesmo lote de partidas com threads duas vezes, sem e com os vizinhos
+ * barulhentos, com as mesmas sementes, e compara:
+ * - latência de acordar: da música parar até o primeiro assento e até a
+ *   última tentativa (as threads dos jogadores saindo do `wait`);
+ * - p99 da resolução e da rodada inteira;
+ * - justiça: vitórias e primeiras eliminações por jogador contra a uniforme,
+ *   e as duas execuções entre si.
+ */
+class HarnessInterferencia {
+public:
+    HarnessInterferencia(const ConfigJogo& config, const ConfigInterferencia& interferencia, uint64_t semente)
+        : config(config), interferencia(interferencia), semente(semente),
+          sem(config.num_jogadores), com(config.num_jogadores) {}
+
+    void executar(uint64_t jogos) {
+        rodar_lote(jogos, sem, fases_sem, segundos_sem);
+        GeradorInterferencia gerador(interferencia);
+        rodar_lote(jogos, com, fases_com, segundos_com);
+        gerador.encerrar();
+        trabalho = gerador.get_trabalho();
+    }
+
+    const RelatorioFases& get_fases_sem() const { return fases_sem; }
+    const RelatorioFases& get_fases_com() const { return fases_com; }
+
+    void relatar(std::ostream& saida) const {
+        const auto formato = saida.flags();
+        const auto precisao = saida.precision();
+        saida << "Interferência: " << interferencia.descrever() << " (" << trabalho << " iterações)\n";
+        saida << "Partidas: " << sem.partidas << " sem em " << std::fixed << std::setprecision(2) << segundos_sem
+              << " s, " << com.partidas << " com em " << segundos_com << " s\n";
+        saida << "Violações de invariantes: " << sem.violacoes << " sem, " << com.violacoes << " com\n\n";
+
+        saida << coluna("latência (µs)", 30) << std::right << std::setw(12) << "sem"
+              << std::setw(12) << "com" << std::setw(10) << "razão" << "\n";
+        auto linha = [&](const std::string& nome, const Histograma& a, const Histograma& b, double q) {
+            double va = a.quantil(q) / 1000.0, vb = b.quantil(q) / 1000.0;
+            saida << coluna(nome, 30) << std::right << std::setprecision(1) << std::setw(12) << va
+                  << std::setw(12) << vb << std::setprecision(2) << std::setw(10) << (va > 0 ? vb / va : 0.0)
+                  << "\n";
+        };
+        for (double q : {0.5, 0.99}) {
+            std::string p = q == 0.5 ? " p50" : " p99";
+            linha("acordar (primeiro assento)" + p, fases_sem.get_fase(PrimeiroAssento),
+                  fases_com.get_fase(PrimeiroAssento), q);
+            linha("acordar (última tentativa)" + p, fases_sem.get_fase(UltimaTentativa),
+                  fases_com.get_fase(UltimaTentativa), q);
+        }
+        linha("resolução p99", fases_sem.get_fase(Resolucao), fases_com.get_fase(Resolucao), 0.99);
+        linha("rodada p99", fases_sem.get_total(), fases_com.get_total(), 0.99);
+
+        ResultadoTeste vit_sem = qui_quadrado_uniforme(sem.vencedores, 1);
+        ResultadoTeste vit_com = qui_quadrado_uniforme(com.vencedores, 1);
+        ResultadoTeste pri_sem = qui_quadrado_uniforme(sem.primeiro_eliminado, 1);
+        ResultadoTeste pri_com = qui_quadrado_uniforme(com.primeiro_eliminado, 1);
+        ResultadoTeste vit_entre = qui_quadrado_duas_amostras(sem.vencedores, com.vencedores);
+        ResultadoTeste pri_entre = qui_quadrado_duas_amostras(sem.primeiro_eliminado, com.primeiro_eliminado);
+        saida << "\njustiça (p-valor do qui-quadrado)    sem vs uniforme  com vs uniforme  sem vs com\n";
+        saida << std::setprecision(4);
+        saida << "  vencedor                           " << std::setw(15) << vit_sem.p_valor << std::setw(17)
+              << vit_com.p_valor << std::setw(12) << vit_entre.p_valor << "\n";
+        saida << "  primeiro eliminado                 " << std::setw(15) << pri_sem.p_valor << std::setw(17)
+              << pri_com.p_valor << std::setw(12) << pri_entre.p_valor << "\n";
+        saida << "\nvitórias por jogador (sem | com):\n";
+        for (size_t id = 1; id < sem.vencedores.size() && id <= 16; ++id) {
+            saida << "  P" << id << ": " << sem.vencedores[id] << " | " << com.vencedores[id] << "\n";
+        }
+        saida.flags(formato);
+        saida.precision(precisao);
+    }
+
+private:
+    void rodar_lote(uint64_t jogos, AmostraMotor& amostra, RelatorioFases& fases, double& segundos) {
+        ConfigJogo partida = config;
+        partida.verboso = false;
+        auto inicio = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < jogos; ++i) {
+            partida.semente = semente + i;
+            amostra.registrar(jogar_partida(partida, nullptr, &fases));
+        }
+        segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    ConfigJogo config;
+    ConfigInterferencia interferencia;
+    uint64_t semente;
+    AmostraMotor sem;
+    AmostraMotor com;
+    RelatorioFases fases_sem;
+    RelatorioFases fases_com;
+    double segundos_sem = 0;
+    double segundos_com = 0;
+    uint64_t trabalho = 0;
+};
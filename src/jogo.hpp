@@ -0,0 +1,724 @@
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <semaphore>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "aleatorio.hpp"
+#include "amostrador.hpp"
+#include "armazem.hpp"
+#include "fases.hpp"
+#include "fila_entradas.hpp"
+#include "justica.hpp"
+#include "pagina_estatisticas.hpp"
+#include "relogio.hpp"
+#include "seqlock.hpp"
+
+// Parâmetros de uma partida do motor com threads.
+struct ConfigJogo {
+    int num_jogadores = 4;       // total de jogadores (locais + externos)
+    int jogadores_externos = 0;  // os últimos ids são reservados para bots externos
+    int vagas_entrada = 0;       // jogadores que ainda podem entrar com a partida em andamento
+    int musica_min_ms = 1000;
+    int musica_max_ms = 3000;
+    int espera_sentar_ms = 500;  // prazo para tentar sentar, contado de quando a música para
+    int espera_cadeira_us = 0;   // quanto quem não acha cadeira livre espera por uma; 0 = não espera
+    int arrendamento_us = 0;     // quem senta levanta depois disso e disputa de novo; 0 = fica sentado
+    int pausa_rodada_ms = 1000;
+    bool verboso = true;
+    uint64_t semente = 0;        // 0 sorteia uma semente nova para o coordenador
+    bool embaralhar_criacao = false;  // cria as threads dos jogadores em ordem sorteada, não por id
+    // Handicap de cada jogador, P1 primeiro: entre os que ficam sem cadeira, a
+    // chance de ser eliminado é proporcional a ele. Jogadores sem entrada têm 1.
+    std::vector<double> handicaps;
+
+    // Maior id possível: os jogadores iniciais e depois as vagas de entrada.
+    int limite_ids() const { return num_jogadores + vagas_entrada; }
+
+    // Pesos de eliminação indexados pelo id (o índice 0 não é jogador), até
+    // `ate_id` quando ele passa de `num_jogadores`.
+    std::vector<uint64_t> pesos_eliminacao(int ate_id = 0) const {
+        std::vector<uint64_t> pesos(std::max(num_jogadores, ate_id) + 1, AmostradorPonderado::PESO_UNITARIO);
+        pesos[0] = 0;
+        for (size_t i = 0; i < handicaps.size() && i + 1 < pesos.size(); ++i) {
+            pesos[i + 1] = AmostradorPonderado::peso_de_handicap(handicaps[i]);
+        }
+        return pesos;
+    }
+
+    // Identifica as regras da partida (não a semente nem a saída no terminal)
+    // para agrupar resultados no armazém.
+    uint64_t identificador() const {
+        uint64_t h = 0;
+        auto misturar = [&h](uint64_t v) { h = SplitMix64::na_posicao(h ^ v, 0); };
+        for (int v : {num_jogadores, musica_min_ms, musica_max_ms, espera_sentar_ms, pausa_rodada_ms, vagas_entrada,
+                      espera_cadeira_us, arrendamento_us}) {
+            misturar(static_cast<uint64_t>(v));
+        }
+        for (uint64_t p : pesos_eliminacao()) misturar(p);
+        return h;
+    }
+};
+
+// Resultado de uma rodada como o coordenador o publica: cadeiras, eliminado
+// e época (número da rodada). Os ocupantes, em ordem de cadeira, vêm à parte.
+struct ResumoRodada {
+    uint64_t epoca = 0;  // 0 = nenhuma rodada resolvida ainda
+    int32_t cadeiras = 0;
+    int32_t eliminado = -1;
+};
+
+struct ResultadoJogo {
+    int vencedor = -1;
+    int rodadas = 0;
+    std::vector<int> ordem_eliminacao;
+};
+
+/*
+ * Uso básico de um counting_semaphore em C++:
+ *
+ * O `std::counting_semaphore` é um mecanismo de sincronização que permite controlar o acesso a um recurso compartilhado
+ * com um número máximo de acessos simultâneos. Neste projeto, ele é usado para gerenciar o número de cadeiras disponíveis.
+ * Inicializamos o semáforo com `n - 1` para representar as cadeiras disponíveis no início do jogo.
+ * Cada jogador que tenta se sentar precisa fazer um `acquire()`, e o semáforo permite que até `n - 1` jogadores
+ * ocupem as cadeiras. Quando todos os assentos estão ocupados, jogadores adicionais ficam bloqueados até que
+ * o coordenador libere o semáforo com `release()`, sinalizando a eliminação dos jogadores.
+ * O método `release()` também pode ser usado para liberar múltiplas permissões de uma só vez, por exemplo: `cadeira_sem.release(3);`,
+ * o que permite destravar várias threads de uma só vez, como é feito na função `liberar_threads_eliminadas()`.
+ *
+ * Métodos da classe `std::counting_semaphore`:
+ *
+ * 1. `acquire()`: Decrementa o contador do semáforo. Bloqueia a thread se o valor for zero.
+ *    - Exemplo de uso: `cadeira_sem.acquire();` // Jogador tenta ocupar uma cadeira.
+ *
+ * 2. `release(int n = 1)`: Incrementa o contador do semáforo em `n`. Pode liberar múltiplas permissões.
+ *    - Exemplo de uso: `cadeira_sem.release(2);` // Libera 2 permissões simultaneamente.
+ */
+class JogoDasCadeiras {
+public:
+    explicit JogoDasCadeiras(const ConfigJogo& config)
+        : config(config), num_jogadores(config.num_jogadores), cadeiras(config.num_jogadores - 1),
+          cadeira_sem(config.num_jogadores - 1), eliminados(config.limite_ids() + 1, 0),
+          admitidos(config.limite_ids() + 1, 0), entradas(config.num_jogadores + 1, config.limite_ids()),
+          resumo(static_cast<size_t>(std::max(1, config.limite_ids()))) {
+        for (int i = 1; i <= num_jogadores; ++i) {
+            jogadores_ativos.push_back(i);
+        }
+        std::fill(admitidos.begin(), admitidos.begin() + num_jogadores + 1, 1);
+        RelogioRapido::calibrar();  // uma vez por processo, antes das threads dos jogadores
+    }
+
+    // Jogador novo com a partida em andamento: reserva um id e entra na fila
+    // sem lock. Ele joga a partir da rodada seguinte à próxima `iniciar_rodada`.
+    // Retorna o id, ou 0 se as vagas de entrada acabaram.
+    int entrar() { return entradas.entrar(); }
+
+    bool tem_entradas() const { return !entradas.vazia(); }
+
+    // Admite quem entrou na fila desde a rodada anterior e ajusta cadeiras e
+    // permissões ao novo número de jogadores, sem parar quem já está jogando.
+    // Retorna os ids admitidos nesta rodada.
+    const std::vector<int>& iniciar_rodada() {
+        admitidos_rodada.clear();
+        entradas.drenar([this](int id) { admitidos_rodada.push_back(id); });
+        if (!admitidos_rodada.empty()) {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            for (int id : admitidos_rodada) admitidos[id] = 1;
+        }
+        {
+            std::lock_guard<std::mutex> lock(jogadores_mutex);
+            jogadores_ativos.insert(jogadores_ativos.end(), admitidos_rodada.begin(), admitidos_rodada.end());
+            cadeiras = jogadores_ativos.size() - 1;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(cadeira_mutex);
+            cadeiras_ocupadas.clear();
+            houve_assento = false;
+
+            // Ressincroniza o semáforo: descarta as permissões que sobraram da rodada anterior
+            // (inclusive as do `release()` de eliminação) e deixa exatamente `cadeiras` livres.
+            // A época avisa quem pegou uma permissão antes disso que ela já foi descontada.
+            auto inicio_ressincronizacao = RelogioRapido::now();
+            while (cadeira_sem.try_acquire()) {}
+            cadeira_sem.release(cadeiras);
+            epoca_semaforo.fetch_add(1, std::memory_order_release);
+            ressincronizacao = RelogioRapido::now() - inicio_ressincronizacao;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            tentativas = 0;
+        }
+
+        if (config.verboso) {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "\n-----------------------------------------------\n";
+            std::cout << "Iniciando rodada com " << num_ativos()
+                      << " jogadores e " << cadeiras << " cadeiras.\n";
+            for (int id : admitidos_rodada) std::cout << "Jogador P" << id << " entrou no jogo.\n";
+            std::cout << "A música está tocando... 🎵\n";
+        }
+        return admitidos_rodada;
+    }
+
+    void parar_musica() {
+        if (config.verboso) {
+            std::lock_guard<std::mutex> lock(cout_mutex);
+            std::cout << "\n> A música parou! Os jogadores estão tentando se sentar...\n";
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            musica_parada = true;
+            ++rodada;
+            instante_parada = RelogioRapido::now();
+            ultima_tentativa = {};
+            prazo_rodada = std::chrono::steady_clock::now() + std::chrono::milliseconds(config.espera_sentar_ms);
+            rodada_aberta.store(rodada, std::memory_order_release);
+        }
+        music_cv.notify_all();
+    }
+
+    void voltar_musica() {
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            musica_parada = false;
+        }
+        music_cv.notify_all();
+    }
+
+    void encerrar() {
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            jogo_ativo = false;
+        }
+        music_cv.notify_all();
+    }
+
+    // Bloqueia até a música parar numa rodada posterior a `rodada_vista`.
+    // Retorna o número da rodada, ou 0 se o jogo acabou ou o jogador foi eliminado.
+    // Quem entrou com a partida em andamento espera também ser admitido.
+    int aguardar_musica_parar(int rodada_vista, int jogador_id = 0) {
+        std::unique_lock<std::mutex> lock(music_mutex);
+        music_cv.wait(lock, [&] {
+            return !jogo_ativo || eliminados[jogador_id] ||
+                   (admitidos[jogador_id] && musica_parada && rodada > rodada_vista);
+        });
+        if (!jogo_ativo || eliminados[jogador_id]) return 0;
+        return rodada;
+    }
+
+    // Tentativa de sentar na rodada `rodada_tentativa`. Depois do prazo (ou
+    // numa rodada que já é outra), a tentativa é recusada: quem se atrasou,
+    // por estar descalendarizado, travado ou lento do outro lado do socket,
+    // conta como sem cadeira e não rouba um assento da rodada seguinte.
+    //
+    // Com `espera_cadeira_us`, quem não acha cadeira livre espera uma com
+    // `try_acquire_until`, nunca além do prazo da rodada. `contar` é falso
+    // quando o jogador volta a disputar depois de levantar (arrendamento): a
+    // rodada já contou a tentativa dele.
+    bool tentar_sentar(int jogador_id, int rodada_tentativa, bool contar = true) {
+        if (rodada_aberta.load(std::memory_order_acquire) != rodada_tentativa) {
+            tentativas_atrasadas.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        const uint64_t epoca = epoca_semaforo.load(std::memory_order_acquire);
+        bool sentou = cadeira_sem.try_acquire();
+        if (!sentou && config.espera_cadeira_us > 0) {
+            auto limite = std::chrono::steady_clock::now() + std::chrono::microseconds(config.espera_cadeira_us);
+            limite = std::min(limite, get_prazo_rodada());
+            sentou = cadeira_sem.try_acquire_until(limite);
+        }
+        if (sentou) {
+            std::lock_guard<std::mutex> lock(cadeira_mutex);
+            if (rodada_aberta.load(std::memory_order_relaxed) != rodada_tentativa) {
+                // O prazo venceu entre a checagem e o acquire. A permissão só
+                // volta ao semáforo se ninguém o ressincronizou desde então:
+                // depois da ressincronização ela já ficou fora da conta, e
+                // devolvê-la daria uma cadeira a mais na rodada seguinte.
+                if (epoca_semaforo.load(std::memory_order_relaxed) == epoca) cadeira_sem.release();
+                tentativas_atrasadas.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            // Uma vez por rodada: com arrendamento a lista esvazia e enche de novo.
+            if (!houve_assento) {
+                primeiro_assento = RelogioRapido::now();
+                houve_assento = true;
+            }
+            cadeiras_ocupadas.emplace_back(jogador_id, static_cast<int>(cadeiras_ocupadas.size()) + 1);
+        }
+        if (!contar) return sentou;
+        {
+            // A rodada pode ter fechado desde a checagem (o `try_acquire_until`
+            // volta exatamente no prazo) e a próxima já ter zerado `tentativas`:
+            // conferir sob o mesmo mutex impede que a tentativa conte na rodada
+            // seguinte e a feche antes de um jogador que ainda não tentou.
+            std::lock_guard<std::mutex> lock(music_mutex);
+            if (rodada_aberta.load(std::memory_order_relaxed) != rodada_tentativa) return sentou;
+            ++tentativas;
+            ultima_tentativa = RelogioRapido::now();
+        }
+        tentativas_cv.notify_all();
+        return sentou;
+    }
+
+    // Fim do arrendamento: o jogador levanta e a cadeira volta ao semáforo,
+    // onde quem está esperando com prazo pode pegá-la. Só vale com a rodada
+    // ainda aberta; depois que ela fecha, os ocupantes não mudam.
+    bool levantar(int jogador_id, int rodada_tentativa) {
+        std::lock_guard<std::mutex> lock(cadeira_mutex);
+        if (rodada_aberta.load(std::memory_order_relaxed) != rodada_tentativa) return false;
+        auto it = std::find_if(cadeiras_ocupadas.begin(), cadeiras_ocupadas.end(),
+                               [jogador_id](const std::pair<int, int>& c) { return c.first == jogador_id; });
+        if (it == cadeiras_ocupadas.end()) return false;
+        cadeiras_ocupadas.erase(it);
+        cadeira_sem.release();
+        levantadas.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Espera até que todos os jogadores ativos tenham tentado sentar, ou até o
+    // prazo da rodada (contado de `parar_musica`), e fecha a rodada: a partir
+    // daqui os ocupantes não mudam. Devolve false se fechou pelo prazo.
+    bool aguardar_tentativas() {
+        const int esperadas = num_ativos();
+        bool todos;
+        {
+            std::unique_lock<std::mutex> lock(music_mutex);
+            todos = tentativas_cv.wait_until(lock, prazo_rodada, [&] { return tentativas >= esperadas; });
+        }
+        std::lock_guard<std::mutex> lock(cadeira_mutex);
+        rodada_aberta.store(0, std::memory_order_relaxed);
+        return todos;
+    }
+
+    std::chrono::steady_clock::time_point get_prazo_rodada() {
+        std::lock_guard<std::mutex> lock(music_mutex);
+        return prazo_rodada;
+    }
+
+    // Fases da rodada que o jogo mede: do instante da parada até a primeira
+    // cadeira e até a última tentativa, e a ressincronização do semáforo.
+    // Chamado pelo coordenador depois de `aguardar_tentativas`.
+    void medir_fases(TemposFases& t) {
+        auto ns = [](RelogioRapido::duration d) {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+        };
+        t.ns[Ressincronizacao] = ns(ressincronizacao);
+        {
+            std::lock_guard<std::mutex> lock(cadeira_mutex);
+            if (houve_assento) t.ns[PrimeiroAssento] = ns(primeiro_assento - instante_parada);
+        }
+        std::lock_guard<std::mutex> lock(music_mutex);
+        if (tentativas > 0) t.ns[UltimaTentativa] = ns(ultima_tentativa - instante_parada);
+    }
+
+    uint64_t get_tentativas_atrasadas() const { return tentativas_atrasadas.load(std::memory_order_relaxed); }
+    uint64_t get_levantadas() const { return levantadas.load(std::memory_order_relaxed); }
+
+    // `release()` adicional para destravar quem ficou esperando no semáforo.
+    void liberar_cadeiras(int n) {
+        cadeira_sem.release(n);
+    }
+
+    void eliminar_jogador(int jogador_id) {
+        {
+            std::lock_guard<std::mutex> lock(jogadores_mutex);
+            jogadores_ativos.erase(std::remove(jogadores_ativos.begin(), jogadores_ativos.end(), jogador_id),
+                                    jogadores_ativos.end());
+        }
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            eliminados[jogador_id] = 1;
+        }
+        music_cv.notify_all();
+    }
+
+    // Publica o resultado da rodada no seqlock. Só o coordenador escreve;
+    // observadores leem com `ler_resumo` sem lock e sem atrasar o coordenador.
+    void publicar_resumo(int eliminado_id, const std::vector<int>& ocupantes) {
+        ResumoRodada r;
+        {
+            std::lock_guard<std::mutex> lock(music_mutex);
+            r.epoca = static_cast<uint64_t>(rodada);
+        }
+        r.cadeiras = cadeiras;
+        r.eliminado = eliminado_id;
+        resumo.escrever(r, ocupantes.data(), ocupantes.size());
+    }
+
+    // Leitura consistente do último resumo: cabeçalho e ocupantes da mesma rodada.
+    ResumoRodada ler_resumo(std::vector<int>& ocupantes) const {
+        ResumoRodada r;
+        resumo.ler(r, ocupantes);
+        return r;
+    }
+
+    void exibir_resultado_rodada() {
+        if (!config.verboso) return;
+        std::vector<int> ocupantes;
+        ResumoRodada r = ler_resumo(ocupantes);
+        std::lock_guard<std::mutex> lock_out(cout_mutex);
+        std::cout << "\n-----------------------------------------------\n";
+        for (size_t i = 0; i < ocupantes.size(); ++i) {
+            std::cout << "[Cadeira " << i + 1 << "]: Ocupada por P" << ocupantes[i] << "\n";
+        }
+        std::cout << "\nJogador P" << r.eliminado << " não conseguiu uma cadeira e foi eliminado!\n";
+        std::cout << "-----------------------------------------------\n";
+    }
+
+    std::vector<int> get_jogadores_sentados() {
+        std::lock_guard<std::mutex> lock(cadeira_mutex);
+        std::vector<int> sentados;
+        for (auto& [id, _] : cadeiras_ocupadas) {
+            sentados.push_back(id);
+        }
+        return sentados;
+    }
+
+    std::vector<int> get_jogadores_ativos() {
+        std::lock_guard<std::mutex> lock(jogadores_mutex);
+        return jogadores_ativos;
+    }
+
+    int num_ativos() {
+        std::lock_guard<std::mutex> lock(jogadores_mutex);
+        return static_cast<int>(jogadores_ativos.size());
+    }
+
+    bool esta_ativo(int jogador_id) {
+        std::lock_guard<std::mutex> lock(music_mutex);
+        return admitidos[jogador_id] && !eliminados[jogador_id];
+    }
+
+    int get_num_jogadores() const { return num_jogadores; }
+    int get_cadeiras() const { return cadeiras; }
+    const ConfigJogo& get_config() const { return config; }
+    std::mutex& get_cout_mutex() { return cout_mutex; }
+
+private:
+    ConfigJogo config;
+    int num_jogadores;
+    int cadeiras;
+
+    std::counting_semaphore<> cadeira_sem;
+    std::condition_variable music_cv;
+    std::condition_variable tentativas_cv;
+    std::mutex music_mutex;
+    bool musica_parada = false;
+    bool jogo_ativo = true;
+    int rodada = 0;
+    int tentativas = 0;
+    std::chrono::steady_clock::time_point prazo_rodada;
+    RelogioRapido::time_point instante_parada;   // protegido por music_mutex
+    RelogioRapido::time_point ultima_tentativa;  // protegido por music_mutex
+    RelogioRapido::time_point primeiro_assento;  // protegido por cadeira_mutex
+    bool houve_assento = false;                  // primeiro_assento vale nesta rodada; idem
+    RelogioRapido::duration ressincronizacao{};  // só o coordenador toca
+    std::atomic<uint64_t> epoca_semaforo{0};     // ressincronizações do semáforo; muda sob cadeira_mutex
+    std::atomic<int> rodada_aberta{0};  // rodada que ainda aceita tentativas; 0 = nenhuma
+    std::atomic<uint64_t> tentativas_atrasadas{0};
+    std::atomic<uint64_t> levantadas{0};  // cadeiras devolvidas no meio da rodada
+    std::vector<char> eliminados;  // indexado pelo id do jogador, protegido por music_mutex
+    std::vector<char> admitidos;   // idem; os iniciais (e o índice 0) já nascem admitidos
+    FilaEntradas entradas;
+    std::vector<int> admitidos_rodada;  // só o coordenador toca
+
+    std::mutex cout_mutex;
+    std::vector<int> jogadores_ativos;
+    std::mutex jogadores_mutex;
+    std::vector<std::pair<int, int>> cadeiras_ocupadas;  // (jogador, cadeira)
+    std::mutex cadeira_mutex;
+
+    SeqlockLista<ResumoRodada, int> resumo;  // ocupantes em ordem de cadeira
+};
+
+class Jogador {
+public:
+    Jogador(int id, JogoDasCadeiras& jogo, std::chrono::milliseconds atraso = {})
+        : id(id), jogo(jogo), eliminado(false), atraso(atraso) {}
+
+    void tentar_ocupar_cadeira(int rodada) {
+        if (atraso.count() > 0) std::this_thread::sleep_for(atraso);  // jogador lento, para testar o prazo
+        bool sentou = jogo.tentar_sentar(id, rodada);
+        // Arrendamento: enquanto a rodada estiver aberta, levanta no fim de
+        // cada período e disputa a cadeira de novo. Vale o resultado final.
+        const int arrendamento_us = jogo.get_config().arrendamento_us;
+        while (sentou && arrendamento_us > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(arrendamento_us));
+            if (!jogo.levantar(id, rodada)) break;
+            sentou = jogo.tentar_sentar(id, rodada, false);
+        }
+        estatisticas.registrar(sentou);
+        if (!sentou) {
+            eliminado = true;
+        }
+    }
+
+    // Tentativas e assentos, no total e por CPU; leia depois do `join`.
+    const EstatisticasJogador& get_estatisticas() const { return estatisticas; }
+
+    bool verificar_eliminacao() {
+        eliminado = !jogo.esta_ativo(id);
+        return eliminado;
+    }
+
+    void joga() {
+        int rodada_vista = 0;
+        while (true) {
+            rodada_vista = jogo.aguardar_musica_parar(rodada_vista, id);
+            if (rodada_vista == 0) break;
+
+            tentar_ocupar_cadeira(rodada_vista);
+        }
+        verificar_eliminacao();
+    }
+
+private:
+    int id;
+    JogoDasCadeiras& jogo;
+    bool eliminado;
+    std::chrono::milliseconds atraso;
+    EstatisticasJogador estatisticas;
+};
+
+/*
+ * Chegadas contínuas: uma thread que, a intervalos exponenciais de média
+ * `intervalo_medio_us`, faz um jogador novo entrar na partida e sobe a thread
+ * dele, até as vagas de entrada acabarem ou `parar()`. Com intervalo 0 as
+ * entradas chegam tão rápido quanto as threads nascem.
+ */
+class GeradorChegadas {
+public:
+    GeradorChegadas(JogoDasCadeiras& jogo, double intervalo_medio_us, uint64_t semente)
+        : jogo(jogo), intervalo_medio_us(intervalo_medio_us), gen(semente), thread(&GeradorChegadas::gerar, this) {}
+
+    ~GeradorChegadas() { parar(); }
+
+    // Para de gerar e espera as threads dos que entraram, que só terminam
+    // quando são eliminados ou a partida acaba.
+    void parar() {
+        ativo.store(false, std::memory_order_relaxed);
+        if (thread.joinable()) thread.join();
+        for (auto& t : threads) t.join();
+        threads.clear();
+    }
+
+    int get_entradas() const { return entradas.load(std::memory_order_relaxed); }
+
+private:
+    void gerar() {
+        while (ativo.load(std::memory_order_relaxed)) {
+            if (intervalo_medio_us > 0) {
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds(static_cast<int64_t>(gen.exponencial(intervalo_medio_us))));
+            }
+            int id = jogo.entrar();
+            if (id == 0) break;
+            jogadores.push_back(std::make_unique<Jogador>(id, jogo));
+            threads.emplace_back(&Jogador::joga, jogadores.back().get());
+            entradas.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    JogoDasCadeiras& jogo;
+    double intervalo_medio_us;
+    GeradorLote gen;
+    std::atomic<bool> ativo{true};
+    std::atomic<int> entradas{0};
+    std::vector<std::unique_ptr<Jogador>> jogadores;
+    std::vector<std::thread> threads;
+    std::thread thread;
+};
+
+class Coordenador {
+public:
+    Coordenador(JogoDasCadeiras& jogo)
+        : jogo(jogo),
+          semente(jogo.get_config().semente ? jogo.get_config().semente : std::random_device{}()),
+          gen(semente), pesos(jogo.get_config().pesos_eliminacao(jogo.get_config().limite_ids())),
+          elegiveis(pesos) {
+        // Vagas de entrada só passam a ter peso quando o jogador é admitido.
+        for (size_t id = jogo.get_num_jogadores() + 1; id < pesos.size(); ++id) elegiveis.remover(id);
+    }
+
+    // Acrescenta o resultado da partida ao armazém quando ela terminar.
+    void registrar_em(EscritorArmazem* destino) { armazem_resultados = destino; }
+
+    // Publica rodada, jogadores, cadeiras e duração das rodadas na página ao vivo.
+    void publicar_em(PaginaEstatisticas* destino) { pagina = destino; }
+
+    void iniciar_jogo() {
+        const ConfigJogo& config = jogo.get_config();
+        while (jogo.num_ativos() > 1 || jogo.tem_entradas()) {
+            auto inicio_rodada = RelogioRapido::now();
+            for (int id : jogo.iniciar_rodada()) {
+                elegiveis.definir(id, pesos[id]);
+                ++entradas_admitidas;
+            }
+            TemposFases tempos;
+            if (pagina) {
+                EstatisticasAoVivo& v = pagina->valores();
+                v.rodada = static_cast<uint64_t>(resultado.rodadas) + 1;
+                v.jogadores_ativos = static_cast<uint64_t>(jogo.num_ativos());
+                v.cadeiras = static_cast<uint64_t>(jogo.get_cadeiras());
+                pagina->publicar();
+            }
+            auto inicio_musica = RelogioRapido::now();
+            sleep_random();
+            tempos.ns[Musica] = nanossegundos_desde(inicio_musica);
+            jogo.parar_musica();
+            if (!jogo.aguardar_tentativas()) ++rodadas_no_prazo;
+            jogo.medir_fases(tempos);
+            liberar_threads_eliminadas(&tempos);
+            jogo.voltar_musica();
+            ++resultado.rodadas;
+            tempos.total_ns = nanossegundos_desde(inicio_rodada);
+            fases.registrar(tempos);
+            duracoes_us.push_back(static_cast<uint32_t>(tempos.total_ns / 1000));
+            if (pagina) {
+                EstatisticasAoVivo& v = pagina->valores();
+                v.jogadores_ativos = static_cast<uint64_t>(jogo.num_ativos());
+                v.duracao_ultima_rodada_us = duracoes_us.back();
+                ++v.rodadas_concluidas;
+                pagina->publicar();
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(config.pausa_rodada_ms));
+        }
+
+        jogo.encerrar();
+        if (pagina) {
+            ++pagina->valores().partidas_concluidas;
+            pagina->publicar();
+        }
+
+        std::vector<int> ativos = jogo.get_jogadores_ativos();
+        if (!ativos.empty()) {
+            resultado.vencedor = ativos[0];
+        }
+        if (armazem_resultados) {
+            armazem_resultados->acrescentar(semente, config.identificador(), resultado.vencedor,
+                                            resultado.ordem_eliminacao, duracoes_us);
+        }
+        if (!ativos.empty() && config.verboso) {
+            std::lock_guard<std::mutex> lock(jogo.get_cout_mutex());
+            std::cout << "\n-----------------------------------------------\n";
+            std::cout << "🏆 Vencedor: Jogador P" << ativos[0] << "! Parabéns! 🏆\n";
+            std::cout << "-----------------------------------------------\n";
+            std::cout << "\nObrigado por jogar o Jogo das Cadeiras Concorrente!\n";
+        }
+    }
+
+    void liberar_threads_eliminadas(TemposFases* tempos = nullptr) {
+        // `elegiveis` guarda os pesos dos jogadores ativos; os sentados saem
+        // só durante o sorteio, e o eliminado sai de vez. Cada sentado volta
+        // com o peso exato que tinha: um id fora da faixa, repetido ou que já
+        // não era elegível não entra no sorteio por engano.
+        auto inicio = RelogioRapido::now();
+        std::vector<int> jogadores_sentados = jogo.get_jogadores_sentados();
+        retirados.clear();
+        for (int id : jogadores_sentados) {
+            if (id < 0 || static_cast<size_t>(id) >= elegiveis.tamanho() || elegiveis.peso(id) == 0) continue;
+            retirados.emplace_back(id, elegiveis.peso(id));
+            elegiveis.remover(id);
+        }
+
+        int eliminado_id = -1;
+        if (elegiveis.total() > 0) {
+            eliminado_id = static_cast<int>(elegiveis.sortear(gen));
+            jogo.eliminar_jogador(eliminado_id);
+            elegiveis.remover(eliminado_id);
+            resultado.ordem_eliminacao.push_back(eliminado_id);
+        }
+
+        for (const auto& [id, peso] : retirados) elegiveis.definir(id, peso);
+
+        jogo.publicar_resumo(eliminado_id, jogadores_sentados);
+        if (tempos) tempos->ns[Resolucao] = nanossegundos_desde(inicio);
+        auto inicio_exibicao = RelogioRapido::now();
+        jogo.exibir_resultado_rodada();
+        if (tempos) tempos->ns[Exibicao] = nanossegundos_desde(inicio_exibicao);
+        jogo.liberar_cadeiras(jogo.get_num_jogadores());
+    }
+
+    const ResultadoJogo& get_resultado() const { return resultado; }
+    int get_rodadas_no_prazo() const { return rodadas_no_prazo; }
+    int get_entradas_admitidas() const { return entradas_admitidas; }
+    const RelatorioFases& get_fases() const { return fases; }
+
+private:
+    static uint64_t nanossegundos_desde(RelogioRapido::time_point inicio) {
+        return static_cast<uint64_t>((RelogioRapido::now() - inicio).count());
+    }
+
+    void sleep_random() {
+        const ConfigJogo& config = jogo.get_config();
+        std::this_thread::sleep_for(std::chrono::milliseconds(gen.entre(config.musica_min_ms, config.musica_max_ms)));
+    }
+
+    JogoDasCadeiras& jogo;
+    uint64_t semente;
+    GeradorLote gen;
+    std::vector<uint64_t> pesos;
+    AmostradorPonderado elegiveis;
+    std::vector<std::pair<int, uint64_t>> retirados;  // sentados fora do sorteio da rodada, com o peso
+    ResultadoJogo resultado;
+    int rodadas_no_prazo = 0;  // rodadas fechadas pelo prazo, com alguém sem tentar
+    int entradas_admitidas = 0;  // jogadores que entraram com a partida em andamento
+    RelatorioFases fases;
+    std::vector<uint32_t> duracoes_us;  // da música começar até as cadeiras voltarem
+    EscritorArmazem* armazem_resultados = nullptr;
+    PaginaEstatisticas* pagina = nullptr;
+};
+
+// Executa uma partida completa do motor com threads, só com jogadores locais.
+// Com `fases`, soma nele a decomposição das rodadas da partida; com `justica`,
+// as tentativas e vitórias por jogador, ordem de criação e CPU.
+inline ResultadoJogo jogar_partida(const ConfigJogo& config, EscritorArmazem* armazem = nullptr,
+                                   RelatorioFases* fases = nullptr, RelatorioJustica* justica = nullptr) {
+    JogoDasCadeiras jogo(config);
+    Coordenador coordenador(jogo);
+    coordenador.registrar_em(armazem);
+
+    std::vector<Jogador> jogadores_objs;
+    jogadores_objs.reserve(config.num_jogadores);
+    for (int i = 1; i <= config.num_jogadores; ++i) {
+        jogadores_objs.emplace_back(i, jogo);
+    }
+
+    // ordem[k] é o índice do jogador cuja thread é a k-ésima a nascer.
+    std::vector<int> ordem(config.num_jogadores);
+    for (int i = 0; i < config.num_jogadores; ++i) ordem[i] = i;
+    if (config.embaralhar_criacao) {
+        GeradorLote gen(config.semente ? SplitMix64::na_posicao(config.semente, 1) : std::random_device{}());
+        gen.embaralhar(ordem);
+    }
+
+    std::vector<std::thread> jogadores_threads;
+    for (int i : ordem) {
+        jogadores_threads.emplace_back(&Jogador::joga, &jogadores_objs[i]);
+    }
+    std::thread coordenador_thread(&Coordenador::iniciar_jogo, &coordenador);
+
+    for (auto& t : jogadores_threads) t.join();
+    coordenador_thread.join();
+    if (fases) fases->somar(coordenador.get_fases());
+    if (justica) {
+        std::vector<int> posicao(config.num_jogadores + 1, 0);
+        std::vector<EstatisticasJogador> por_id(config.num_jogadores + 1);
+        for (int k = 0; k < config.num_jogadores; ++k) posicao[ordem[k] + 1] = k + 1;
+        for (int i = 0; i < config.num_jogadores; ++i) por_id[i + 1] = jogadores_objs[i].get_estatisticas();
+        justica->registrar(coordenador.get_resultado().vencedor, posicao, por_id);
+    }
+    return coordenador.get_resultado();
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <sched.h>
+
+#include "estatistica.hpp"
+
+/*
+ * Justiça do motor com threads: quem ganha o `try_acquire()` depende só da
+ * sorte, ou também do id do jogador, da ordem em que a thread dele foi criada
+ * e da CPU onde ela roda?
+ *
+ * Cada jogador conta, na própria thread e sem compartilhar nada, as tentativas
+ * de sentar e os assentos conseguidos, no total e por CPU (`sched_getcpu` na
+ * hora da tentativa). No fim da partida `RelatorioJustica` soma essas contagens
+ * por id, por posição na ordem de criação e por CPU, junto com as vitórias.
+ * Com a ordem de criação embaralhada (`ConfigJogo::embaralhar_criacao`), id e
+ * ordem deixam de coincidir e os dois efeitos podem ser separados.
+ */
+struct EstatisticasJogador {
+    uint64_t tentativas = 0;
+    uint64_t assentos = 0;
+    int ultima_cpu = -1;
+    std::vector<uint64_t> tentativas_cpu;
+    std::vector<uint64_t> assentos_cpu;
+
+    void registrar(bool sentou) {
+        ++tentativas;
+        assentos += sentou;
+        int cpu = ::sched_getcpu();
+        if (cpu < 0) return;
+        if (static_cast<size_t>(cpu) >= tentativas_cpu.size()) {
+            tentativas_cpu.resize(cpu + 1, 0);
+            assentos_cpu.resize(cpu + 1, 0);
+        }
+        ++tentativas_cpu[cpu];
+        assentos_cpu[cpu] += sentou;
+        ultima_cpu = cpu;
+    }
+};
+
+class RelatorioJustica {
+public:
+    // `posicao[id]` é a ordem de criação da thread do jogador (1 = primeira) e
+    // `jogadores[id]` as contagens dele; o índice 0 não é jogador. A vitória
+    // conta para a CPU da última tentativa do vencedor.
+    void registrar(int vencedor, const std::vector<int>& posicao, const std::vector<EstatisticasJogador>& jogadores) {
+        ++partidas;
+        por_id.garantir(jogadores.size());
+        por_ordem.garantir(jogadores.size());
+        for (size_t id = 1; id < jogadores.size(); ++id) {
+            const EstatisticasJogador& e = jogadores[id];
+            por_id.tentativas[id] += e.tentativas;
+            por_id.assentos[id] += e.assentos;
+            por_ordem.tentativas[posicao[id]] += e.tentativas;
+            por_ordem.assentos[posicao[id]] += e.assentos;
+            por_cpu.garantir(e.tentativas_cpu.size());
+            for (size_t cpu = 0; cpu < e.tentativas_cpu.size(); ++cpu) {
+                por_cpu.tentativas[cpu] += e.tentativas_cpu[cpu];
+                por_cpu.assentos[cpu] += e.assentos_cpu[cpu];
+            }
+        }
+        if (vencedor < 1 || static_cast<size_t>(vencedor) >= jogadores.size()) return;
+        ++por_id.vitorias[vencedor];
+        ++por_ordem.vitorias[posicao[vencedor]];
+        int cpu = jogadores[vencedor].ultima_cpu;
+        if (cpu >= 0) {
+            por_cpu.garantir(cpu + 1);
+            ++por_cpu.vitorias[cpu];
+        }
+    }
+
+    uint64_t get_partidas() const { return partidas; }
+
+    // Tabelas por id, ordem de criação e CPU e os testes de significância.
+    // Retorna true se nenhum viés foi significativo ao nível `alfa`.
+    //
+    // Vitórias são testadas contra a uniforme; taxas de assento, por
+    // homogeneidade entre as classes. As tentativas de uma mesma rodada não
+    // são independentes (há exatamente uma cadeira a menos), o que deixa o
+    // teste de assento conservador.
+    bool imprimir(std::ostream& saida, double alfa) const {
+        const auto formato = saida.flags();
+        const auto precisao = saida.precision();
+        saida << "Partidas: " << partidas << "\n";
+        tabela(saida, "jogador", "P", por_id, 1);
+        tabela(saida, "ordem de criação", "#", por_ordem, 1);
+        tabela(saida, "CPU", "cpu", por_cpu, 0);
+
+        struct Linha {
+            std::string nome;
+            ResultadoTeste r;
+        };
+        std::vector<Linha> linhas = {
+            {"vitórias por jogador", qui_quadrado_uniforme(por_id.vitorias, 1)},
+            {"vitórias por ordem de criação", qui_quadrado_uniforme(por_ordem.vitorias, 1)},
+            {"assentos por jogador", qui_quadrado_proporcoes(por_id.assentos, por_id.tentativas, 1)},
+            {"assentos por ordem de criação", qui_quadrado_proporcoes(por_ordem.assentos, por_ordem.tentativas, 1)},
+            {"assentos por CPU", qui_quadrado_proporcoes(por_cpu.assentos, por_cpu.tentativas, 0)},
+        };
+        bool justo = true;
+        saida << "\n" << coluna("teste (qui-quadrado)", 34) << coluna("estatística", 13) << coluna("gl", 6)
+              << "p-valor\n";
+        for (const Linha& l : linhas) {
+            bool vies = l.r.graus_liberdade > 0 && l.r.p_valor < alfa;
+            justo = justo && !vies;
+            saida << coluna(l.nome, 34) << std::left << std::setw(13) << std::setprecision(4) << l.r.estatistica
+                  << std::setw(6) << l.r.graus_liberdade << std::setprecision(4) << l.r.p_valor
+                  << (vies ? "  <-- viés" : "") << "\n";
+        }
+        saida << "\n" << (justo ? "Nenhum viés significativo" : "VIÉS detectado") << " (alfa = " << alfa << ")\n";
+        saida.flags(formato);
+        saida.precision(precisao);
+        return justo;
+    }
+
+private:
+    struct Contagens {
+        std::vector<uint64_t> vitorias;
+        std::vector<uint64_t> tentativas;
+        std::vector<uint64_t> assentos;
+
+        void garantir(size_t n) {
+            if (n <= tentativas.size()) return;
+            vitorias.resize(n, 0);
+            tentativas.resize(n, 0);
+            assentos.resize(n, 0);
+        }
+    };
+
+    void tabela(std::ostream& saida, const std::string& titulo, const std::string& prefixo, const Contagens& c,
+                size_t inicio) const {
+        saida << "\n" << coluna(titulo, 18) << std::right << std::setw(10) << "vitórias" << std::setw(10) << "taxa"
+              << std::setw(13) << "tentativas" << std::setw(10) << "assento" << "\n";
+        for (size_t i = inicio; i < c.tentativas.size(); ++i) {
+            if (c.tentativas[i] == 0 && c.vitorias[i] == 0) continue;
+            double taxa_vitoria = partidas ? static_cast<double>(c.vitorias[i]) / partidas : 0.0;
+            double taxa_assento = c.tentativas[i] ? static_cast<double>(c.assentos[i]) / c.tentativas[i] : 0.0;
+            saida << coluna(prefixo + std::to_string(i), 18) << std::right << std::setw(9) << c.vitorias[i]
+                  << std::setw(10) << std::fixed << std::setprecision(4) << taxa_vitoria << std::setw(13)
+                  << c.tentativas[i] << std::setw(10) << taxa_assento << "\n";
+            saida.unsetf(std::ios::fixed);
+        }
+    }
+
+    uint64_t partidas = 0;
+    Contagens por_id;
+    Contagens por_ordem;
+    Contagens por_cpu;
+};
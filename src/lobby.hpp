@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <thread>
+#include <vector>
+
+#include "aleatorio.hpp"
+#include "histograma.hpp"
+#include "partida.hpp"
+#include "pool_partidas.hpp"
+#include "relogio.hpp"
+
+/*
+ * Lobby de formação de partidas: recebe um fluxo contínuo de jogadores,
+ * agrupa-os pela ordem de chegada em partidas de `modelo.num_jogadores` e
+ * entrega cada partida ao PoolPartidas assim que ela fecha, sem esperar um
+ * lote.
+ *
+ * No máximo `limite_pendentes` partidas ficam no pool ao mesmo tempo. Com o
+ * pool saturado, a partida formada espera uma vaga ainda no lobby, em vez de
+ * engordar a fila do pool sem limite. A espera no lobby de cada jogador vai
+ * da chegada até a partida dele ser entregue ao pool.
+ *
+ * `chegar()` pode ser chamado de várias threads. O grupo em formação fica
+ * sob um mutex, e quem espera vaga segura o mutex, o que segura também os
+ * próximos a chegar. As vagas e o contador de concluídas ficam fora do
+ * lobby, então o pool pode terminar as partidas pendentes depois que o lobby
+ * deixar de existir.
+ */
+class Lobby {
+public:
+    Lobby(PoolPartidas& pool, const EspecJogo& modelo, uint64_t semente, ptrdiff_t limite_pendentes = 4096)
+        : pool(pool), modelo(modelo), semente(semente), pendentes(std::make_shared<Pendentes>(limite_pendentes)),
+          entrega(std::make_shared<PoolPartidas::Entrega>(
+              [p = pendentes](std::vector<ResultadoCompacto>&& resultados) {
+                  p->concluidas.fetch_add(resultados.size(), std::memory_order_relaxed);
+                  p->vagas.release(static_cast<ptrdiff_t>(resultados.size()));
+              })) {
+        grupo.reserve(std::max<uint32_t>(1, modelo.num_jogadores));
+    }
+
+    void chegar() {
+        const auto agora = RelogioRapido::now();
+        EspecJogo espec;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++chegadas;
+            grupo.push_back(agora);
+            if (grupo.size() < std::max<uint32_t>(1, modelo.num_jogadores)) return;
+            pendentes->vagas.acquire();
+            const auto entregue = RelogioRapido::now();
+            for (auto chegada : grupo) {
+                if (chegada >= inicio_medicao) {
+                    espera_ns.registrar(static_cast<uint64_t>((entregue - chegada).count()));
+                }
+            }
+            grupo.clear();
+            espec = modelo;
+            espec.id = static_cast<uint32_t>(formadas);
+            espec.semente = semente + formadas;
+            ++formadas;
+        }
+        pool.submeter({espec}, entrega, 1);
+    }
+
+    // Descarta o aquecimento: a espera só conta para quem chegar daqui em diante.
+    void iniciar_medicao() {
+        std::lock_guard<std::mutex> lock(mutex);
+        inicio_medicao = RelogioRapido::now();
+        espera_ns = Histograma();
+    }
+
+    Histograma get_espera_ns() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return espera_ns;
+    }
+
+    uint64_t get_chegadas() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return chegadas;
+    }
+
+    uint64_t get_formadas() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return formadas;
+    }
+
+    uint64_t get_concluidas() const { return pendentes->concluidas.load(std::memory_order_relaxed); }
+
+private:
+    struct Pendentes {
+        explicit Pendentes(ptrdiff_t limite) : vagas(std::max<ptrdiff_t>(1, limite)) {}
+        std::counting_semaphore<> vagas;
+        std::atomic<uint64_t> concluidas{0};
+    };
+
+    PoolPartidas& pool;
+    EspecJogo modelo;
+    uint64_t semente;
+    std::shared_ptr<Pendentes> pendentes;
+    std::shared_ptr<PoolPartidas::Entrega> entrega;
+    mutable std::mutex mutex;
+    std::vector<RelogioRapido::time_point> grupo;  // chegadas da partida em formação
+    RelogioRapido::time_point inicio_medicao{};
+    Histograma espera_ns;
+    uint64_t chegadas = 0;
+    uint64_t formadas = 0;
+};
+
+struct CargaLobby {
+    double jogadores_por_s = 100000;  // 0 = tão rápido quanto os produtores conseguem
+    int produtores = 1;
+    double aquecimento_s = 1.0;
+    double duracao_s = 5.0;
+};
+
+struct MedicaoLobby {
+    double segundos = 0;
+    uint64_t chegadas = 0;
+    uint64_t formadas = 0;
+    uint64_t concluidas = 0;
+    uint64_t pendentes = 0;  // no pool, ainda não concluídas, no fim da janela
+    Histograma espera_ns;
+};
+
+/*
+ * Gera chegadas com intervalos exponenciais (processo de Poisson) dividido
+ * entre `produtores` threads. Cada produtor agenda a próxima chegada a partir
+ * da anterior, não de quando acordou: se o sono passar do ponto, as chegadas
+ * atrasadas saem em seguida e a taxa média se mantém. Mede só a janela depois
+ * do aquecimento, quando o lobby e o pool já estão em regime.
+ */
+inline MedicaoLobby medir_lobby(Lobby& lobby, const CargaLobby& carga, uint64_t semente) {
+    const int produtores = std::max(1, carga.produtores);
+    const double intervalo_medio_ns = carga.jogadores_por_s > 0 ? 1e9 * produtores / carga.jogadores_por_s : 0.0;
+    std::atomic<bool> ativo{true};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < produtores; ++p) {
+        threads.emplace_back([&, p] {
+            GeradorLote gen(SplitMix64::na_posicao(semente, static_cast<uint64_t>(p)));
+            auto proxima = std::chrono::steady_clock::now();
+            while (ativo.load(std::memory_order_relaxed)) {
+                if (intervalo_medio_ns > 0) {
+                    proxima += std::chrono::nanoseconds(static_cast<int64_t>(gen.exponencial(intervalo_medio_ns)));
+                    if (proxima > std::chrono::steady_clock::now()) std::this_thread::sleep_until(proxima);
+                }
+                lobby.chegar();
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(carga.aquecimento_s));
+    lobby.iniciar_medicao();
+    const auto inicio = std::chrono::steady_clock::now();
+    const uint64_t chegadas_inicio = lobby.get_chegadas();
+    const uint64_t formadas_inicio = lobby.get_formadas();
+    const uint64_t concluidas_inicio = lobby.get_concluidas();
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(carga.duracao_s));
+    MedicaoLobby m;
+    m.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    m.chegadas = lobby.get_chegadas() - chegadas_inicio;
+    m.formadas = lobby.get_formadas() - formadas_inicio;
+    m.concluidas = lobby.get_concluidas() - concluidas_inicio;
+    m.espera_ns = lobby.get_espera_ns();
+    m.pendentes = lobby.get_formadas() - lobby.get_concluidas();
+
+    ativo.store(false, std::memory_order_relaxed);
+    for (auto& t : threads) t.join();
+    return m;
+}
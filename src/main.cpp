@@ -1,250 +1,720 @@
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <thread>
 #include <vector>
-#include <mutex>
-#include <condition_variable>
-#include <semaphore>
-#include <atomic>
-#include <chrono>
-#include <random>
-#include <algorithm>
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include "checkpoint.hpp"
+#include "diferencial.hpp"
+#include "equipes.hpp"
+#include "espera_temporizada.hpp"
+#include "interferencia.hpp"
+#include "jogo.hpp"
+#include "lobby.hpp"
+#include "motor_eventos.hpp"
+#include "opcoes.hpp"
+#include "ponte_bots.hpp"
+#include "simulador_simd.hpp"
+#include "varredura.hpp"
+
+extern char** environ;
 
-// Global variables for synchronization
 constexpr int NUM_JOGADORES = 4;
-std::counting_semaphore<NUM_JOGADORES>* cadeira_sem = new std::counting_semaphore<NUM_JOGADORES>(NUM_JOGADORES - 1);
-std::condition_variable music_cv;
-std::mutex music_mutex;
-std::atomic<bool> musica_parada{false};
-std::atomic<bool> jogo_ativo{true};
-std::mutex cout_mutex;
-std::vector<int> jogadores_ativos;
-std::mutex jogadores_mutex;
-std::vector<std::pair<int, int>> cadeiras_ocupadas;
-std::mutex cadeira_mutex;
-
-void sleep_random() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1000, 3000);
-    std::this_thread::sleep_for(std::chrono::milliseconds(dis(gen)));
-}
-/*
- * Uso básico de um counting_semaphore em C++:
- * 
- * O `std::counting_semaphore` é um mecanismo de sincronização que permite controlar o acesso a um recurso compartilhado 
- * com um número máximo de acessos simultâneos. Neste projeto, ele é usado para gerenciar o número de cadeiras disponíveis.
- * Inicializamos o semáforo com `n - 1` para representar as cadeiras disponíveis no início do jogo. 
- * Cada jogador que tenta se sentar precisa fazer um `acquire()`, e o semáforo permite que até `n - 1` jogadores 
- * ocupem as cadeiras. Quando todos os assentos estão ocupados, jogadores adicionais ficam bloqueados até que 
- * o coordenador libere o semáforo com `release()`, sinalizando a eliminação dos jogadores.
- * O método `release()` também pode ser usado para liberar múltiplas permissões de uma só vez, por exemplo: `cadeira_sem.release(3);`,
- * o que permite destravar várias threads de uma só vez, como é feito na função `liberar_threads_eliminadas()`.
- *
- * Métodos da classe `std::counting_semaphore`:
- * 
- * 1. `acquire()`: Decrementa o contador do semáforo. Bloqueia a thread se o valor for zero.
- *    - Exemplo de uso: `cadeira_sem.acquire();` // Jogador tenta ocupar uma cadeira.
- * 
- * 2. `release(int n = 1)`: Incrementa o contador do semáforo em `n`. Pode liberar múltiplas permissões.
- *    - Exemplo de uso: `cadeira_sem.release(2);` // Libera 2 permissões simultaneamente.
- */
-class JogoDasCadeiras {
-public:
-    JogoDasCadeiras(int num_jogadores)
-        : num_jogadores(num_jogadores), cadeiras(num_jogadores - 1) {
-        for (int i = 1; i <= num_jogadores; ++i) {
-            jogadores_ativos.push_back(i);
-        }
-    }
 
-    void iniciar_rodada() {
-        {
-            std::lock_guard<std::mutex> lock(jogadores_mutex);
-            cadeiras = jogadores_ativos.size() - 1;
+// Sobe `processos` instâncias do bot de referência dividindo `quantidade` jogadores.
+std::vector<pid_t> iniciar_bots(const Opcoes& opcoes, const std::string& socket, int quantidade, int processos) {
+    std::string executavel = opcoes.texto("bot", opcoes.diretorio_programa() + "/BotJogador");
+    std::vector<pid_t> pids;
+    for (int p = 0; p < processos; ++p) {
+        int parte = quantidade / processos + (p < quantidade % processos ? 1 : 0);
+        if (parte == 0) continue;
+        std::string jogadores = std::to_string(parte);
+        std::vector<std::string> args = {executavel, "--socket", socket, "--jogadores", jogadores};
+        if (opcoes.tem("reacao-max-us")) {
+            args.push_back("--reacao-max-us");
+            args.push_back(opcoes.texto("reacao-max-us"));
         }
+        std::vector<char*> argv;
+        for (auto& a : args) argv.push_back(a.data());
+        argv.push_back(nullptr);
 
-        {
-            std::lock_guard<std::mutex> lock(cadeira_mutex);
-            cadeiras_ocupadas.clear();
+        pid_t pid;
+        if (posix_spawn(&pid, executavel.c_str(), nullptr, nullptr, argv.data(), environ) == 0) {
+            pids.push_back(pid);
+        } else {
+            std::cerr << "Não foi possível iniciar " << executavel << "\n";
         }
+    }
+    return pids;
+}
 
-        {
-            std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << "\n-----------------------------------------------\n";
-            std::cout << "Iniciando rodada com " << jogadores_ativos.size()
-                      << " jogadores e " << cadeiras << " cadeiras.\n";
-            std::cout << "A música está tocando... 🎵\n";
-        }
+// "1,2.5,1" -> {1, 2.5, 1}
+std::vector<double> ler_lista(const std::string& texto) {
+    std::vector<double> valores;
+    std::stringstream ss(texto);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) valores.push_back(std::atof(item.c_str()));
     }
+    return valores;
+}
 
-    void parar_musica() {
-        {
-            std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << "\n> A música parou! Os jogadores estão tentando se sentar...\n";
-        }
+// A música de cada rodada dura U[min, max] ms: os dois limites precisam ser
+// não negativos e formar um intervalo.
+bool faixa_musica_valida(int musica_min_ms, int musica_max_ms) {
+    if (musica_min_ms < 0 || musica_max_ms < musica_min_ms) {
+        std::cerr << "Faixa de música inválida: --musica-min-ms e --musica-max-ms devem ser >= 0 e min <= max\n";
+        return false;
+    }
+    return true;
+}
 
-        {
-            std::lock_guard<std::mutex> lock(music_mutex);
-            musica_parada = true;
-        }
-        music_cv.notify_all();
+// Lê das opções os parâmetros comuns aos modos que executam partidas.
+ConfigJogo ler_config(const Opcoes& opcoes) {
+    ConfigJogo config;
+    config.num_jogadores = static_cast<int>(opcoes.inteiro("jogadores", NUM_JOGADORES));
+    config.musica_min_ms = static_cast<int>(opcoes.inteiro("musica-min-ms", config.musica_min_ms));
+    config.musica_max_ms = static_cast<int>(opcoes.inteiro("musica-max-ms", config.musica_max_ms));
+    config.espera_sentar_ms = static_cast<int>(opcoes.inteiro("espera-sentar-ms", config.espera_sentar_ms));
+    config.pausa_rodada_ms = static_cast<int>(opcoes.inteiro("pausa-rodada-ms", config.pausa_rodada_ms));
+    config.espera_cadeira_us = static_cast<int>(opcoes.inteiro("espera-cadeira-us", 0));
+    config.arrendamento_us = static_cast<int>(opcoes.inteiro("arrendamento-us", 0));
+    config.verboso = !opcoes.tem("silencioso");
+    config.handicaps = ler_lista(opcoes.texto("handicaps"));
+    if (opcoes.tem("rapido")) {
+        config.musica_min_ms = 5;
+        config.musica_max_ms = 20;
+        config.pausa_rodada_ms = 0;
     }
+    return config;
+}
+
+// `ler_config` para os modos que jogam lotes de partidas com threads: música
+// curta e sem pausa entre rodadas, salvo se as opções disserem outra coisa.
+ConfigJogo ler_config_lote(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config(opcoes);
+    config.musica_min_ms = static_cast<int>(opcoes.inteiro("musica-min-ms", 0));
+    config.musica_max_ms = static_cast<int>(opcoes.inteiro("musica-max-ms", 1));
+    config.espera_sentar_ms = static_cast<int>(opcoes.inteiro("espera-sentar-ms", 200));
+    config.pausa_rodada_ms = static_cast<int>(opcoes.inteiro("pausa-rodada-ms", 0));
+    return config;
+}
 
-    void eliminar_jogador(int jogador_id) {
-        {
-            std::lock_guard<std::mutex> lock(jogadores_mutex);
-            jogadores_ativos.erase(std::remove(jogadores_ativos.begin(), jogadores_ativos.end(), jogador_id),
-                                    jogadores_ativos.end());
+// Executa partidas no motor de eventos discretos e resume as estatísticas.
+int executar_simulacao(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+    if (config.num_jogadores < 2) {
+        std::cerr << "A simulação precisa de pelo menos 2 jogadores\n";
+        return 2;
+    }
+    ModeloReacao reacao;
+    reacao.media_us = opcoes.real("reacao-media-us", reacao.media_us);
+    reacao.fatores = ler_lista(opcoes.texto("fatores-reacao"));
+    uint64_t jogos = static_cast<uint64_t>(opcoes.inteiro("jogos", 1000000));
+    uint64_t semente = static_cast<uint64_t>(opcoes.inteiro("semente", 1));
+
+    std::unique_ptr<EscritorArmazem> armazem;
+    try {
+        if (opcoes.tem("armazem")) armazem = std::make_unique<EscritorArmazem>(opcoes.texto("armazem"));
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    std::unique_ptr<CodificadorEventos> eventos;
+    const uint64_t config_id = reacao.identificador(config);
+    std::vector<uint32_t> duracoes_us;
+
+    MotorEventos motor(config, reacao);
+    std::vector<uint64_t> vitorias(config.num_jogadores + 1, 0);
+    uint64_t rodadas = 0;
+    uint64_t i = 0;
+
+    // Contexto da execução no checkpoint; a partida em andamento vem depois.
+    auto salvar_contexto = [&](checkpoint::Escrita& saida) {
+        saida.natural(config_id);
+        saida.real(reacao.media_us);
+        saida.natural(reacao.fatores.size());
+        for (double f : reacao.fatores) saida.real(f);
+        saida.natural(semente);
+        saida.natural(jogos);
+        saida.natural(i);
+        saida.natural(rodadas);
+        for (uint64_t v : vitorias) saida.natural(v);
+    };
+    std::vector<uint8_t> salvo;
+    std::unique_ptr<checkpoint::Leitura> retomada;
+    if (opcoes.tem("retomar")) {
+        if (!opcoes.tem("checkpoint")) {
+            std::cerr << "--retomar precisa de --checkpoint ARQUIVO\n";
+            return 2;
+        }
+        salvo = checkpoint::ler(opcoes.texto("checkpoint"));
+        retomada = std::make_unique<checkpoint::Leitura>(salvo);
+        bool mesma_config = retomada->natural() == config_id && retomada->real() == reacao.media_us &&
+                            retomada->tamanho() == reacao.fatores.size();
+        for (size_t f = 0; mesma_config && f < reacao.fatores.size(); ++f) {
+            mesma_config = retomada->real() == reacao.fatores[f];
         }
+        if (!mesma_config) {
+            std::cerr << "O checkpoint é de outra configuração; use as mesmas opções de jogo da execução original.\n";
+            return 1;
+        }
+        semente = retomada->natural();
+        jogos = retomada->natural();
+        i = retomada->natural();
+        rodadas = retomada->natural();
+        for (uint64_t& v : vitorias) v = retomada->natural();
+        std::cout << "Retomando na partida " << i + 1 << " de " << jogos << "\n";
     }
-
-    void exibir_resultado_rodada(int eliminado_id) {
-        std::lock_guard<std::mutex> lock_out(cout_mutex);
-        std::cout << "\n-----------------------------------------------\n";
-        for (size_t i = 0; i < cadeiras_ocupadas.size(); ++i) {
-            std::cout << "[Cadeira " << i + 1 << "]: Ocupada por P" << cadeiras_ocupadas[i].first << "\n";
+    if (opcoes.tem("eventos")) {
+        // Ao retomar, o log continua de onde parou em vez de ser recriado.
+        try {
+            registro::Continuacao continuacao;
+            if (retomada) continuacao = continuar_log_eventos(opcoes.texto("eventos"));
+            eventos = std::make_unique<CodificadorEventos>(opcoes.texto("eventos"), continuacao);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
         }
-        std::cout << "\nJogador P" << eliminado_id << " não conseguiu uma cadeira e foi eliminado!\n";
-        std::cout << "-----------------------------------------------\n";
+        motor.registrar_eventos(eventos.get());
+    }
+    std::unique_ptr<GravadorCheckpoint> gravador;
+    if (opcoes.tem("checkpoint")) {
+        auto intervalo = std::chrono::milliseconds(opcoes.inteiro("checkpoint-ms", 60000));
+        gravador = std::make_unique<GravadorCheckpoint>(opcoes.texto("checkpoint"), intervalo);
+        motor.salvar_entre_rodadas(gravador.get(), [&](const MotorEventos& m) {
+            checkpoint::Escrita saida;
+            salvar_contexto(saida);
+            m.salvar_partida(saida);
+            gravador->entregar(std::move(saida.get_dados()));
+        });
     }
 
-    int get_num_jogadores() const { return num_jogadores; }
-    int get_cadeiras() const { return cadeiras; }
-    const std::vector<int>& get_jogadores_ativos() const { return jogadores_ativos; }
-
-private:
-    int num_jogadores;
-    int cadeiras;
-};
-
-class Jogador {
-public:
-    Jogador(int id, JogoDasCadeiras& jogo)
-        : id(id), jogo(jogo), eliminado(false) {}
-
-    void tentar_ocupar_cadeira() {
-        if (cadeira_sem->try_acquire()) {
-            std::lock_guard<std::mutex> lock(cadeira_mutex);
-            cadeiras_ocupadas.emplace_back(id, id);
-        } else {
-            eliminado = true;
+    std::unique_ptr<PaginaEstatisticas> pagina;
+    if (opcoes.tem("pagina")) pagina = std::make_unique<PaginaEstatisticas>(opcoes.texto("pagina"));
+
+    const uint64_t primeiro = i;
+    auto inicio = std::chrono::steady_clock::now();
+    for (; i < jogos; ++i) {
+        const ResultadoSimulado& r = retomada ? motor.retomar(*retomada) : motor.executar(semente + i);
+        retomada.reset();
+        if (r.vencedor > 0) ++vitorias[r.vencedor];
+        rodadas += r.rodadas;
+        if (armazem) {
+            duracoes_us.clear();
+            for (const RodadaSimulada& d : r.rodadas_detalhe) {
+                duracoes_us.push_back(static_cast<uint32_t>((d.duracao_musica_ns + d.duracao_resolucao_ns) / 1000));
+            }
+            armazem->acrescentar(semente + i, config_id, r.vencedor, r.ordem_eliminacao, duracoes_us);
+        }
+        // Publica a cada 1024 partidas (e sempre em partidas longas): o relógio
+        // custaria mais que uma partida curta inteira.
+        if (pagina && ((i & 1023) == 0 || r.rodadas > 256)) {
+            EstatisticasAoVivo& v = pagina->valores();
+            v.rodada = static_cast<uint64_t>(r.rodadas);
+            v.jogadores_ativos = 1;
+            v.cadeiras = 0;
+            if (!r.rodadas_detalhe.empty()) {
+                const RodadaSimulada& ultima = r.rodadas_detalhe.back();
+                v.duracao_ultima_rodada_us = static_cast<uint64_t>((ultima.duracao_musica_ns + ultima.duracao_resolucao_ns) / 1000);
+            }
+            v.partidas_concluidas = i + 1;
+            v.rodadas_concluidas = rodadas;
+            pagina->publicar();
         }
     }
+    if (pagina) {
+        pagina->valores().partidas_concluidas = jogos;
+        pagina->valores().rodadas_concluidas = rodadas;
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
 
+    std::cout << jogos - primeiro << " partidas simuladas em " << segundos << " s ("
+              << static_cast<uint64_t>((jogos - primeiro) / segundos) << " partidas/s), "
+              << static_cast<double>(rodadas) / jogos << " rodadas em média\n";
+    for (int id = 1; id <= config.num_jogadores && id <= 16; ++id) {
+        std::cout << "  P" << id << ": " << 100.0 * vitorias[id] / jogos << "% das vitórias\n";
+    }
+    if (gravador) std::cout << gravador->get_gravados() << " checkpoints gravados\n";
+    if (eventos) {
+        eventos.reset();  // espera o codificador esvaziar a fila
+        double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        std::cout << "Log de eventos gravado em " << total << " s (" << total - segundos
+                  << " s esperando o codificador depois da última partida)\n";
+    }
+    return 0;
+}
 
-    void joga() {
-        while (jogo_ativo) {
-            {
-                std::unique_lock<std::mutex> lock(music_mutex);
-                music_cv.wait(lock, []{ return musica_parada.load(); });
+// Lê um log de eventos rodada a rodada e resume o tempo até cada cadeira.
+int executar_leitura_eventos(const Opcoes& opcoes) {
+    if (!opcoes.tem("arquivo")) {
+        std::cerr << "uso: JogoDasCadeiras eventos --arquivo LOG\n";
+        return 2;
+    }
+    std::vector<double> soma_ms;
+    std::vector<uint64_t> ocupacoes;
+    uint64_t rodadas = 0, eventos = 0, sem_cadeira = 0, partidas = 0;
+    uint64_t ultima_partida = 0;
+    RodadaEventos rodada;
+    auto inicio = std::chrono::steady_clock::now();
+    try {
+        DecodificadorEventos leitor(opcoes.texto("arquivo"));
+        while (leitor.proxima(rodada)) {
+            if (rodadas == 0 || rodada.partida != ultima_partida) ++partidas;
+            ultima_partida = rodada.partida;
+            ++rodadas;
+            eventos += rodada.eventos.size();
+            for (const EventoAssento& e : rodada.eventos) {
+                if (e.cadeira == 0) {
+                    ++sem_cadeira;
+                    continue;
+                }
+                size_t i = static_cast<size_t>(e.cadeira - 1);
+                if (i >= soma_ms.size()) {
+                    soma_ms.resize(i + 1, 0);
+                    ocupacoes.resize(i + 1, 0);
+                }
+                soma_ms[i] += static_cast<double>(e.instante_ns - rodada.base_ns) / 1e6;
+                ++ocupacoes[i];
             }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::cout << eventos << " eventos em " << rodadas << " rodadas de " << partidas << " partidas, lidos em "
+              << segundos << " s (" << static_cast<uint64_t>(eventos / segundos) << " eventos/s)\n";
+    std::cout << "Tentativas sem cadeira: " << sem_cadeira << "\n";
+    for (size_t i = 0; i < soma_ms.size() && i < 16; ++i) {
+        std::cout << "  cadeira " << i + 1 << ": ocupada em média " << soma_ms[i] / ocupacoes[i]
+                  << " ms após a música parar\n";
+    }
+    return 0;
+}
 
-            if (!jogo_ativo) break;
-
-            tentar_ocupar_cadeira();
+// Monte Carlo em lote: uma partida por lane de vetor.
+int executar_lote_simd(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+    ModeloReacao reacao;
+    reacao.media_us = opcoes.real("reacao-media-us", reacao.media_us);
+    uint64_t jogos = static_cast<uint64_t>(opcoes.inteiro("jogos", 100000000));
+
+    std::unique_ptr<SimuladorLotes> construido;
+    try {
+        construido = std::make_unique<SimuladorLotes>(config, reacao, static_cast<int>(opcoes.inteiro("largura", 0)));
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        return 2;
+    }
+    const SimuladorLotes& simulador = *construido;
+    auto inicio = std::chrono::steady_clock::now();
+    EstatisticasLote est = simulador.executar(jogos, static_cast<uint64_t>(opcoes.inteiro("semente", 1)));
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+
+    std::cout << est.partidas << " partidas em " << segundos << " s ("
+              << static_cast<uint64_t>(est.partidas / segundos) << " partidas/s, "
+              << simulador.get_lanes() << " lanes " << simulador.get_isa() << ")\n";
+    std::cout << "Música média por partida: " << static_cast<double>(est.musica_total_ms) / est.partidas << " ms\n";
+    for (int id = 1; id <= config.num_jogadores && id <= 16; ++id) {
+        std::cout << "  P" << id << ": " << 100.0 * est.vitorias[id] / est.partidas << "% das vitórias, "
+                  << 100.0 * est.primeiro_eliminado[id] / est.partidas << "% primeiro eliminado\n";
+    }
+    return 0;
+}
 
-            {
-                std::unique_lock<std::mutex> lock(music_mutex);
-                music_cv.wait(lock, []{ return !musica_parada.load(); });
+// Varredura de Monte Carlo no motor em pool, com parada por intervalo de confiança.
+int executar_varredura(const Opcoes& opcoes) {
+    CriterioParada criterio;
+    criterio.meia_largura_vitoria = opcoes.real("meia-largura-vitoria", criterio.meia_largura_vitoria);
+    criterio.erro_relativo_custo = opcoes.real("erro-custo", criterio.erro_relativo_custo);
+    criterio.tamanho_lote = static_cast<uint32_t>(opcoes.inteiro("lote", criterio.tamanho_lote));
+    criterio.partidas_maximas = static_cast<uint64_t>(opcoes.inteiro("max-partidas", criterio.partidas_maximas));
+
+    // Cronogramas separados por ';', porque cada um já usa ','.
+    std::vector<std::string> cronogramas;
+    std::stringstream ss(opcoes.texto("cronogramas", "1"));
+    for (std::string item; std::getline(ss, item, ';');) cronogramas.push_back(item);
+    std::vector<ModoEspera> modos;
+    std::string esperas = opcoes.texto("esperas", "condicao,eventfd");
+    if (esperas.find("condicao") != std::string::npos) modos.push_back(ModoEspera::CondicaoMusica);
+    if (esperas.find("eventfd") != std::string::npos) modos.push_back(ModoEspera::EventFd);
+
+    std::ofstream arquivo;
+    if (opcoes.tem("csv")) arquivo.open(opcoes.texto("csv"));
+    std::ostream& csv = arquivo.is_open() ? arquivo : std::cout;
+
+    Varredura varredura(static_cast<int>(opcoes.inteiro("workers", 0)),
+                        static_cast<uint32_t>(opcoes.inteiro("musica-us", 0)), criterio,
+                        static_cast<uint64_t>(opcoes.inteiro("semente", 1)));
+    std::unique_ptr<CacheResultados> cache;
+    if (opcoes.tem("cache")) {
+        cache = std::make_unique<CacheResultados>(opcoes.texto("cache"),
+                                                  static_cast<size_t>(opcoes.inteiro("cache-mb", 64)));
+        varredura.usar_cache(cache.get());
+    }
+    Varredura::escrever_cabecalho_csv(csv);
+    for (double jogadores : ler_lista(opcoes.texto("jogadores-lista", "4,8,16"))) {
+        for (const std::string& cronograma : cronogramas) {
+            for (ModoEspera modo : modos) {
+                ResultadoCelula r = varredura.executar({static_cast<int>(jogadores), cronograma, modo});
+                Varredura::escrever_csv(csv, r);
+                csv.flush();
+                std::cerr << r.celula.num_jogadores << " jogadores, cronograma " << cronograma << ", "
+                          << nome_modo(modo) << ": " << r.partidas << " partidas em " << r.segundos << " s"
+                          << (cache ? " (" + std::to_string(r.do_cache) + " do cache)" : std::string())
+                          << (r.convergiu ? "" : " (limite de partidas, sem convergir)") << "\n";
             }
         }
     }
+    return 0;
+}
 
-private:
-    int id;
-    JogoDasCadeiras& jogo;
-    bool eliminado;
-};
-
-class Coordenador {
-public:
-    Coordenador(JogoDasCadeiras& jogo)
-        : jogo(jogo) {}
-
-    void iniciar_jogo() {
-        while (jogo.get_jogadores_ativos().size() > 1) {
-            jogo.iniciar_rodada();
-            sleep_random();
-            jogo.parar_musica();
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
-            liberar_threads_eliminadas();
-
-            {
-                std::lock_guard<std::mutex> lock(music_mutex);
-                musica_parada = false;
-            }
+// Compara as distribuições do motor com threads com as do motor de referência.
+int executar_diferencial(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config_lote(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+    ModeloReacao reacao;
+    reacao.media_us = opcoes.real("reacao-media-us", reacao.media_us);
+
+    HarnessDiferencial harness(config, reacao, static_cast<uint64_t>(opcoes.inteiro("semente", 1)));
+    harness.executar(static_cast<uint64_t>(opcoes.inteiro("jogos", 2000)));
+    bool ok = harness.relatar(std::cout, opcoes.real("alfa", 0.001));
+    if (opcoes.tem("fases")) {
+        std::cout << "\n";
+        harness.get_fases().imprimir(std::cout, "Fases do motor com threads no lote");
+    }
+    return ok ? 0 : 1;
+}
 
-            delete cadeira_sem;
-            cadeira_sem = new std::counting_semaphore<NUM_JOGADORES>(jogo.get_jogadores_ativos().size() - 1);
-            std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+// Partidas por equipes: cada equipe senta com k cadeiras de uma vez ou não senta.
+int executar_equipes(const Opcoes& opcoes) {
+    ConfigEquipes config;
+    config.equipes = static_cast<int>(opcoes.inteiro("equipes", config.equipes));
+    config.tamanho = static_cast<int>(opcoes.inteiro("tamanho", config.tamanho));
+    config.musica_min_ms = static_cast<int>(opcoes.inteiro("musica-min-ms", config.musica_min_ms));
+    config.musica_max_ms = static_cast<int>(opcoes.inteiro("musica-max-ms", config.musica_max_ms));
+    config.espera_sentar_ms = static_cast<int>(opcoes.inteiro("espera-sentar-ms", config.espera_sentar_ms));
+    config.semente = static_cast<uint64_t>(opcoes.inteiro("semente", 0));
+    const long long jogos = opcoes.inteiro("jogos", 1);
+    config.verboso = jogos == 1 && !opcoes.tem("silencioso");
+    if (config.equipes < 2 || config.tamanho < 1) {
+        std::cerr << "São necessárias ao menos 2 equipes de 1 jogador\n";
+        return 1;
+    }
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 1;
+
+    std::vector<uint64_t> vitorias(config.equipes + 1, 0);
+    uint64_t violacoes = 0;
+    for (long long j = 0; j < jogos; ++j) {
+        ConfigEquipes partida = config;
+        if (config.semente) partida.semente = config.semente + static_cast<uint64_t>(j);
+        ResultadoEquipes r = JogoEquipes(partida).jogar();
+        ++vitorias[r.vencedora];
+        violacoes += r.violacoes;
+    }
+    if (jogos > 1) {
+        std::cout << jogos << " partidas de " << config.equipes << " equipes de " << config.tamanho << "\n";
+        for (int e = 1; e <= config.equipes; ++e) std::cout << "  E" << e << ": " << vitorias[e] << " vitórias\n";
+    }
+    std::cout << "Rodadas com cadeiras inconsistentes: " << violacoes << "\n";
+    return violacoes == 0 ? 0 : 1;
+}
+
+// Posse de k permissões: CAS tudo ou nada contra k `try_acquire` com devolução.
+int executar_permissoes(const Opcoes& opcoes) {
+    const double segundos = opcoes.real("segundos", 0.5);
+    std::cout << "estrategia,threads,k,posses_por_s,falhas_pct,desfeitas,menor_por_thread,maior_por_thread\n";
+    for (double threads : ler_lista(opcoes.texto("threads-lista", "1,2,4,8"))) {
+        for (double k : ler_lista(opcoes.texto("k-lista", "1,2,4"))) {
+            for (EstrategiaPosse e : {EstrategiaPosse::Cas, EstrategiaPosse::Semaforo}) {
+                MedicaoPosse m = medir_posse(e, static_cast<int>(threads), static_cast<int>(k), segundos);
+                uint64_t tentativas = std::max<uint64_t>(1, m.posses + m.falhas);
+                std::cout << nome_estrategia(e) << "," << m.threads << "," << m.k << "," << m.posses / m.segundos
+                          << "," << 100.0 * m.falhas / tentativas << "," << m.desfeitas << "," << m.menor_por_thread
+                          << "," << m.maior_por_thread << "\n";
+            }
         }
+    }
+    return 0;
+}
 
-        jogo_ativo = false;
-        music_cv.notify_all();
+// Caminho com prazo: try_acquire_until do semáforo contra PermissoesAtomicas.
+int executar_espera(const Opcoes& opcoes) {
+    const uint64_t imediatas = static_cast<uint64_t>(opcoes.inteiro("imediatas", 2000000));
+    const uint64_t expiracoes = static_cast<uint64_t>(opcoes.inteiro("expiracoes", 2000));
+    const auto prazo = std::chrono::microseconds(opcoes.inteiro("prazo-us", 100));
+    const int esperando = static_cast<int>(opcoes.inteiro("esperando", 4));
+    const auto intervalo = std::chrono::microseconds(opcoes.inteiro("intervalo-us", 500));
+    const double segundos = opcoes.real("segundos", 1.0);
+
+    std::vector<MedicaoEspera> medicoes = {
+        medir_espera_imediata<AdaptadorSemaforo>(imediatas),
+        medir_espera_imediata<AdaptadorAtomicas>(imediatas),
+        medir_espera_expira<AdaptadorSemaforo>(expiracoes, prazo),
+        medir_espera_expira<AdaptadorAtomicas>(expiracoes, prazo),
+        medir_espera_entrega<AdaptadorSemaforo>(esperando, intervalo, segundos),
+        medir_espera_entrega<AdaptadorAtomicas>(esperando, intervalo, segundos),
+    };
+    std::cout << "primitiva,cenario,operacoes,ns_por_operacao,expiradas,atraso_p50_us,atraso_p99_us,atraso_max_us\n";
+    for (const MedicaoEspera& m : medicoes) {
+        std::cout << m.primitiva << "," << m.cenario << "," << m.operacoes << "," << m.ns_por_operacao << ","
+                  << m.expiradas << "," << m.atraso_ns.quantil(0.5) / 1000.0 << ","
+                  << m.atraso_ns.quantil(0.99) / 1000.0 << "," << m.atraso_ns.quantil(1.0) / 1000.0 << "\n";
+    }
+    return 0;
+}
 
-        if (!jogo.get_jogadores_ativos().empty()) {
-            std::lock_guard<std::mutex> lock(cout_mutex);
-            std::cout << "\n-----------------------------------------------\n";
-            std::cout << "🏆 Vencedor: Jogador P" << jogo.get_jogadores_ativos()[0] << "! Parabéns! 🏆\n";
-            std::cout << "-----------------------------------------------\n";
-            std::cout << "\nObrigado por jogar o Jogo das Cadeiras Concorrente!\n";
-        }
+// Lobby contínuo: forma partidas a partir de um fluxo de jogadores e mede a
+// espera no lobby e as partidas por segundo em regime.
+int executar_lobby(const Opcoes& opcoes) {
+    EspecJogo modelo;
+    modelo.num_jogadores = static_cast<uint32_t>(opcoes.inteiro("jogadores", NUM_JOGADORES));
+    modelo.musica_us = static_cast<uint32_t>(opcoes.inteiro("musica-us", 0));
+    modelo.politica = static_cast<uint8_t>(opcoes.tem("persistente") ? PoliticaReacao::Persistente
+                                                                     : PoliticaReacao::Aleatoria);
+    ModoEspera modo = opcoes.texto("espera", "condicao") == "eventfd" ? ModoEspera::EventFd
+                                                                      : ModoEspera::CondicaoMusica;
+    CargaLobby carga;
+    carga.jogadores_por_s = opcoes.real("taxa", carga.jogadores_por_s);
+    carga.produtores = static_cast<int>(opcoes.inteiro("produtores", carga.produtores));
+    carga.aquecimento_s = opcoes.real("aquecimento-s", carga.aquecimento_s);
+    carga.duracao_s = opcoes.real("segundos", carga.duracao_s);
+    const uint64_t semente = static_cast<uint64_t>(opcoes.inteiro("semente", 1));
+
+    PoolPartidas pool(static_cast<int>(opcoes.inteiro("workers", 0)), modo);
+    Lobby lobby(pool, modelo, semente, static_cast<ptrdiff_t>(opcoes.inteiro("pendentes", 4096)));
+    MedicaoLobby m = medir_lobby(lobby, carga, semente);
+
+    std::cout << "Lobby: partidas de " << modelo.num_jogadores << " jogadores, " << pool.get_num_workers()
+              << " workers (" << nome_modo(modo) << "), " << carga.produtores << " produtores\n";
+    std::cout << "Janela de " << m.segundos << " s depois de " << carga.aquecimento_s << " s de aquecimento\n";
+    std::cout << "  chegadas:            " << m.chegadas / m.segundos << " jogadores/s";
+    if (carga.jogadores_por_s > 0) std::cout << " (oferta de " << carga.jogadores_por_s << ")";
+    std::cout << "\n";
+    std::cout << "  partidas formadas:   " << m.formadas / m.segundos << " /s\n";
+    std::cout << "  partidas concluídas: " << m.concluidas / m.segundos << " /s\n";
+    std::cout << "  pendentes no pool:   " << m.pendentes << "\n";
+    std::cout << "  espera no lobby (µs): p50 " << m.espera_ns.quantil(0.5) / 1000.0 << ", p90 "
+              << m.espera_ns.quantil(0.9) / 1000.0 << ", p99 " << m.espera_ns.quantil(0.99) / 1000.0 << ", máx "
+              << m.espera_ns.quantil(1.0) / 1000.0 << "\n";
+    return 0;
+}
 
-        delete cadeira_sem;
+// Vitórias e assentos por jogador, ordem de criação e CPU, com testes de viés.
+int executar_justica(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config_lote(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+    config.verboso = false;
+    config.embaralhar_criacao = opcoes.tem("embaralhar");
+
+    const uint64_t semente = static_cast<uint64_t>(opcoes.inteiro("semente", 1));
+    const uint64_t jogos = static_cast<uint64_t>(opcoes.inteiro("jogos", 2000));
+    RelatorioJustica justica;
+    for (uint64_t i = 0; i < jogos; ++i) {
+        config.semente = semente + i;
+        jogar_partida(config, nullptr, nullptr, &justica);
     }
+    std::cout << "Ordem de criação das threads: " << (config.embaralhar_criacao ? "sorteada" : "por id") << "\n";
+    return justica.imprimir(std::cout, opcoes.real("alfa", 0.001)) ? 0 : 1;
+}
 
-    void liberar_threads_eliminadas() {
-        std::vector<int> jogadores_sentados;
-        {
-            std::lock_guard<std::mutex> lock(cadeira_mutex);
-            for (auto& [id, _] : cadeiras_ocupadas) {
-                jogadores_sentados.push_back(id);
-            }
-        }
+// Mede latência de acordar, p99 das rodadas e justiça sem e com vizinhos barulhentos.
+int executar_interferencia(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config_lote(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+
+    ConfigInterferencia interferencia;
+    interferencia.cpu = static_cast<int>(opcoes.inteiro("cpu", 1));
+    interferencia.memoria = static_cast<int>(opcoes.inteiro("memoria", 1));
+    interferencia.cache = static_cast<int>(opcoes.inteiro("cache", 1));
+    interferencia.memoria_mb = static_cast<size_t>(opcoes.inteiro("memoria-mb", 256));
+    interferencia.cache_kb = static_cast<size_t>(opcoes.inteiro("cache-kb", 0));
+    if (interferencia.vazia()) {
+        std::cerr << "Nenhuma thread de interferência (--cpu, --memoria, --cache)\n";
+        return 1;
+    }
 
-        int eliminado_id = -1;
-        std::vector<int> candidatos;
+    HarnessInterferencia harness(config, interferencia, static_cast<uint64_t>(opcoes.inteiro("semente", 1)));
+    harness.executar(static_cast<uint64_t>(opcoes.inteiro("jogos", 300)));
+    harness.relatar(std::cout);
+    if (opcoes.tem("fases")) {
+        std::cout << "\n";
+        harness.get_fases_sem().imprimir(std::cout, "Fases sem interferência");
+        std::cout << "\n";
+        harness.get_fases_com().imprimir(std::cout, "Fases com interferência");
+    }
+    return 0;
+}
 
-        for (int id : jogo.get_jogadores_ativos()) {
-            if (std::find(jogadores_sentados.begin(), jogadores_sentados.end(), id) == jogadores_sentados.end()) {
-                candidatos.push_back(id);
-            }
-        }
+// Mostra a calibração do relógio rápido e compara o custo por leitura com o steady_clock.
+int executar_relogio(const Opcoes& opcoes) {
+    RelogioRapido::calibrar();
+    std::cout << "Relógio: " << RelogioRapido::get_descricao() << "\n";
+    const long long leituras = opcoes.inteiro("leituras", 10000000);
+    auto custo = [leituras](auto agora) {
+        auto inicio = std::chrono::steady_clock::now();
+        int64_t soma = 0;
+        for (long long i = 0; i < leituras; ++i) soma += agora().time_since_epoch().count() & 1;
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - inicio).count();
+        return ns / leituras + static_cast<double>(soma) * 0.0;
+    };
+    std::cout << "  RelogioRapido::now(): " << custo([] { return RelogioRapido::now(); }) << " ns por leitura\n";
+    std::cout << "  steady_clock::now():  " << custo([] { return std::chrono::steady_clock::now(); })
+              << " ns por leitura\n";
+
+    // Deriva contra o steady_clock ao longo de `--deriva-ms`.
+    auto rapido = RelogioRapido::now();
+    auto referencia = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(opcoes.inteiro("deriva-ms", 1000)));
+    auto d_rapido = RelogioRapido::now() - rapido;
+    auto d_referencia = std::chrono::steady_clock::now() - referencia;
+    std::cout << "  deriva em " << std::chrono::duration<double, std::milli>(d_referencia).count() << " ms: "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(d_rapido - d_referencia).count() << " ns\n";
+    return 0;
+}
 
-        if (!candidatos.empty()) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<> dis(0, candidatos.size() - 1);
-            eliminado_id = candidatos[dis(gen)];
-            jogo.eliminar_jogador(eliminado_id);
+// Lê a página de estatísticas de outro processo a cada intervalo, até ele terminar.
+int executar_monitor(const Opcoes& opcoes) {
+    if (!opcoes.tem("pagina")) {
+        std::cerr << "uso: JogoDasCadeiras monitor --pagina NOME [--intervalo-ms N]\n";
+        return 2;
+    }
+    auto intervalo = std::chrono::milliseconds(opcoes.inteiro("intervalo-ms", 500));
+    try {
+        LeitorPagina leitor(opcoes.texto("pagina"));
+        std::cout << "Monitorando o processo " << leitor.get_pid() << "\n";
+        while (true) {
+            EstatisticasAoVivo v = leitor.ler();
+            std::cout << "partidas " << v.partidas_concluidas << "  rodada " << v.rodada << "  ativos "
+                      << v.jogadores_ativos << "  cadeiras " << v.cadeiras << "  última rodada "
+                      << v.duracao_ultima_rodada_us << " µs  (" << leitor.get_versao() << " publicações)\n";
+            if (v.encerrado) break;
+            std::this_thread::sleep_for(intervalo);
         }
-
-        jogo.exibir_resultado_rodada(eliminado_id);
-        cadeira_sem->release(NUM_JOGADORES);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
     }
+    return 0;
+}
 
-private:
-    JogoDasCadeiras& jogo;
-};
+int executar_jogo(const Opcoes& opcoes) {
+    ConfigJogo config = ler_config(opcoes);
+    if (!faixa_musica_valida(config.musica_min_ms, config.musica_max_ms)) return 2;
+    int locais = config.num_jogadores;
+    config.jogadores_externos = static_cast<int>(opcoes.inteiro("bots", 0));
+    config.num_jogadores = locais + config.jogadores_externos;
+    config.vagas_entrada = static_cast<int>(opcoes.inteiro("entradas", 0));
 
-int main() {
-    std::cout << "-----------------------------------------------\n";
-    std::cout << "Bem-vindo ao Jogo das Cadeiras Concorrente!\n";
-    std::cout << "-----------------------------------------------\n\n";
+    if (config.verboso) {
+        std::cout << "-----------------------------------------------\n";
+        std::cout << "Bem-vindo ao Jogo das Cadeiras Concorrente!\n";
+        std::cout << "-----------------------------------------------\n\n";
+    }
 
-    JogoDasCadeiras jogo(NUM_JOGADORES);
+    JogoDasCadeiras jogo(config);
     Coordenador coordenador(jogo);
     std::vector<std::thread> jogadores_threads;
+    std::unique_ptr<EscritorArmazem> armazem;
+    if (opcoes.tem("armazem")) {
+        try {
+            armazem = std::make_unique<EscritorArmazem>(opcoes.texto("armazem"));
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        coordenador.registrar_em(armazem.get());
+    }
+    std::unique_ptr<PaginaEstatisticas> pagina;
+    if (opcoes.tem("pagina")) {
+        pagina = std::make_unique<PaginaEstatisticas>(opcoes.texto("pagina"));
+        coordenador.publicar_em(pagina.get());
+    }
 
+    std::unique_ptr<PonteBots> ponte;
+    std::vector<pid_t> bots;
+    if (config.jogadores_externos > 0) {
+        std::string socket = opcoes.texto("socket", "/tmp/jogo_das_cadeiras.sock");
+        try {
+            ponte = std::make_unique<PonteBots>(jogo, socket, locais + 1, config.jogadores_externos);
+            ponte->abrir();
+            if (!opcoes.tem("sem-bot-local")) {
+                bots = iniciar_bots(opcoes, socket, config.jogadores_externos,
+                                    static_cast<int>(opcoes.inteiro("processos-bot", 1)));
+            }
+            ponte->aguardar_registros(std::chrono::milliseconds(opcoes.inteiro("prazo-registro-ms", 10000)));
+        } catch (const std::exception& e) {
+            // Sem a ponte a partida não começa: encerra os bots já iniciados
+            // para não deixá-los órfãos presos no socket.
+            for (pid_t pid : bots) kill(pid, SIGTERM);
+            for (pid_t pid : bots) waitpid(pid, nullptr, 0);
+            std::cerr << "Erro na ponte de bots: " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    // `--lento ID` atrasa a tentativa de um jogador para exercitar o prazo da rodada.
+    const int lento = static_cast<int>(opcoes.inteiro("lento", 0));
+    const auto atraso_lento = std::chrono::milliseconds(opcoes.inteiro("atraso-lento-ms", 2LL * config.espera_sentar_ms));
     std::vector<Jogador> jogadores_objs;
-    for (int i = 1; i <= NUM_JOGADORES; ++i) {
-        jogadores_objs.emplace_back(i, jogo);
+    for (int i = 1; i <= locais; ++i) {
+        jogadores_objs.emplace_back(i, jogo, i == lento ? atraso_lento : std::chrono::milliseconds{});
     }
 
-    for (int i = 0; i < NUM_JOGADORES; ++i) {
+    for (int i = 0; i < locais; ++i) {
         jogadores_threads.emplace_back(&Jogador::joga, &jogadores_objs[i]);
     }
 
+    std::thread ponte_thread;
+    if (ponte) {
+        ponte_thread = std::thread(&PonteBots::executar, ponte.get());
+    }
+
+    // Observadores leem o resumo publicado sem lock e conferem a consistência
+    // de cada leitura: ocupantes distintos, eliminado fora das cadeiras, época
+    // que só cresce.
+    std::atomic<bool> observando{true};
+    std::atomic<uint64_t> leituras{0}, inconsistentes{0};
+    std::vector<std::thread> observadores;
+    for (long long o = 0; o < opcoes.inteiro("observadores", 0); ++o) {
+        observadores.emplace_back([&] {
+            std::vector<int> ocupantes;
+            uint64_t epoca_vista = 0, n = 0, erros = 0;
+            while (observando.load(std::memory_order_relaxed)) {
+                ResumoRodada r = jogo.ler_resumo(ocupantes);
+                std::vector<int> ordenados = ocupantes;
+                std::sort(ordenados.begin(), ordenados.end());
+                bool ok = r.epoca >= epoca_vista && static_cast<int>(ocupantes.size()) <= std::max(r.cadeiras, 0) &&
+                          std::adjacent_find(ordenados.begin(), ordenados.end()) == ordenados.end() &&
+                          !std::binary_search(ordenados.begin(), ordenados.end(), r.eliminado);
+                erros += ok ? 0 : 1;
+                epoca_vista = r.epoca;
+                ++n;
+            }
+            leituras += n;
+            inconsistentes += erros;
+        });
+    }
+
+    // `--entradas N` deixa N jogadores entrarem com a partida em andamento,
+    // chegando a cada `--chegada-media-us` em média.
+    std::unique_ptr<GeradorChegadas> chegadas;
+    if (config.vagas_entrada > 0) {
+        chegadas = std::make_unique<GeradorChegadas>(jogo, opcoes.real("chegada-media-us", 1000.0),
+                                                     static_cast<uint64_t>(opcoes.inteiro("semente", 1)));
+    }
+
     std::thread coordenador_thread(&Coordenador::iniciar_jogo, &coordenador);
 
     for (auto& t : jogadores_threads) {
@@ -256,6 +726,79 @@ int main() {
     if (coordenador_thread.joinable()) {
         coordenador_thread.join();
     }
+    if (chegadas) {
+        chegadas->parar();
+        std::cout << chegadas->get_entradas() << " jogadores entraram com a partida em andamento, "
+                  << coordenador.get_entradas_admitidas() << " admitidos antes do fim, "
+                  << coordenador.get_resultado().rodadas << " rodadas\n";
+    }
+    observando = false;
+    for (auto& t : observadores) t.join();
+    if (opcoes.tem("fases")) coordenador.get_fases().imprimir(std::cout, "\nFases da partida");
+    if (coordenador.get_rodadas_no_prazo() > 0 || jogo.get_tentativas_atrasadas() > 0) {
+        std::cout << coordenador.get_rodadas_no_prazo() << " rodadas fechadas pelo prazo de " << config.espera_sentar_ms
+                  << " ms, " << jogo.get_tentativas_atrasadas() << " tentativas atrasadas recusadas\n";
+    }
+    if (jogo.get_levantadas() > 0) {
+        std::cout << jogo.get_levantadas() << " cadeiras devolvidas no meio da rodada por fim de arrendamento\n";
+    }
+    if (!observadores.empty()) {
+        std::cout << observadores.size() << " observadores: " << leituras << " leituras do resumo, "
+                  << inconsistentes << " inconsistentes\n";
+    }
+
+    if (ponte) {
+        ponte_thread.join();
+        ponte->encerrar(coordenador.get_resultado().vencedor);
+        ponte->exibir_latencias();
+        for (pid_t pid : bots) {
+            waitpid(pid, nullptr, 0);
+        }
+    }
 
     return 0;
 }
+
+int main(int argc, char** argv) {
+    Opcoes opcoes(argc, argv);
+    if (opcoes.modo() == "simular") {
+        return executar_simulacao(opcoes);
+    }
+    if (opcoes.modo() == "relogio") {
+        return executar_relogio(opcoes);
+    }
+    if (opcoes.modo() == "monitor") {
+        return executar_monitor(opcoes);
+    }
+    if (opcoes.modo() == "eventos") {
+        return executar_leitura_eventos(opcoes);
+    }
+    if (opcoes.modo() == "lote-simd") {
+        return executar_lote_simd(opcoes);
+    }
+    if (opcoes.modo() == "varredura") {
+        return executar_varredura(opcoes);
+    }
+    if (opcoes.modo() == "equipes") {
+        return executar_equipes(opcoes);
+    }
+    if (opcoes.modo() == "permissoes") {
+        return executar_permissoes(opcoes);
+    }
+    if (opcoes.modo() == "espera") {
+        return executar_espera(opcoes);
+    }
+    if (opcoes.modo() == "lobby") {
+        return executar_lobby(opcoes);
+    }
+    if (opcoes.modo() == "justica") {
+        return executar_justica(opcoes);
+    }
+    if (opcoes.modo() == "interferencia") {
+        return executar_interferencia(opcoes);
+    }
+    if (opcoes.modo() == "diferencial") {
+        return executar_diferencial(opcoes);
+    }
+    return executar_jogo(opcoes);
+}
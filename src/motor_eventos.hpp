@@ -0,0 +1,289 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "aleatorio.hpp"
+#include "checkpoint.hpp"
+#include "jogo.hpp"
+#include "registro_eventos.hpp"
+
+/*
+ * Motor de eventos discretos: as mesmas regras de JogoDasCadeiras/Coordenador,
+ * sem threads e com tempo simulado.
+ *
+ * - A música de cada rodada dura U[musica_min_ms, musica_max_ms].
+ * - Quando ela para, cada jogador ativo tenta sentar depois de um atraso de
+ *   reação sorteado; as primeiras `cadeiras` tentativas conseguem permissão.
+ * - O coordenador resolve a rodada quando todos tentaram ou quando vence o
+ *   prazo `espera_sentar_ms`, o que vier antes; quem não tentou a tempo fica
+ *   sem cadeira.
+ * - Um dos jogadores sem cadeira, sorteado, é eliminado.
+ *
+ * Dada a semente, o resultado é determinístico. É o oráculo de corretude do
+ * motor com threads e a forma barata de gerar estatísticas em volume.
+ *
+ * Com `registrar_eventos`, cada tentativa de sentar vai para o log compacto
+ * (ver registro_eventos.hpp), com a semente como id da partida e instantes
+ * em tempo simulado.
+ *
+ * Entre rodadas o estado é retomável: com `salvar_entre_rodadas`, o motor
+ * chama o callback no início de uma rodada sempre que o gravador pedir um
+ * checkpoint, e `retomar` continua a partida de onde ela parou, com o mesmo
+ * resultado que teria sem a interrupção.
+ */
+struct ModeloReacao {
+    double media_us = 50.0;  // atraso de reação exponencial, em microssegundos
+    double minimo_us = 5.0;  // latência mínima de acordar uma thread
+    // Multiplicador da média de cada jogador, P1 primeiro (vazio = todos 1).
+    // Como os atrasos são exponenciais, a ordem de chegada é um sorteio sem
+    // reposição ponderado por 1 / fator.
+    std::vector<double> fatores;
+
+    double media_de(int jogador) const {
+        size_t i = static_cast<size_t>(jogador - 1);
+        return i < fatores.size() ? media_us * fatores[i] : media_us;
+    }
+
+    // `ConfigJogo::identificador()` com o modelo misturado: no armazém,
+    // partidas simuladas com reações diferentes ficam em grupos diferentes.
+    uint64_t identificador(const ConfigJogo& config) const {
+        uint64_t h = config.identificador();
+        auto misturar = [&h](uint64_t v) { h = SplitMix64::na_posicao(h ^ v, 0); };
+        misturar(std::bit_cast<uint64_t>(media_us));
+        misturar(std::bit_cast<uint64_t>(minimo_us));
+        misturar(fatores.size());
+        for (double f : fatores) misturar(std::bit_cast<uint64_t>(f));
+        return h;
+    }
+};
+
+struct RodadaSimulada {
+    int64_t duracao_musica_ns = 0;
+    int64_t duracao_resolucao_ns = 0;  // da parada da música até a resolução
+};
+
+struct ResultadoSimulado : ResultadoJogo {
+    std::vector<RodadaSimulada> rodadas_detalhe;
+    int64_t tempo_total_ns = 0;
+};
+
+class MotorEventos {
+public:
+    MotorEventos(const ConfigJogo& config, ModeloReacao reacao = {})
+        : config(config), modelo(reacao), pesos(config.pesos_eliminacao()) {
+        fila.reserve(static_cast<size_t>(config.num_jogadores) * 2 + 4);
+    }
+
+    void registrar_eventos(CodificadorEventos* codificador) { eventos = codificador; }
+
+    // `salvar` recebe o motor parado no início de uma rodada e grava o
+    // próprio contexto seguido de `salvar_partida`.
+    void salvar_entre_rodadas(GravadorCheckpoint* gravador, std::function<void(const MotorEventos&)> salvar) {
+        checkpoints = gravador;
+        salvar_checkpoint = std::move(salvar);
+    }
+
+    // O resultado devolvido vale até a próxima chamada; os buffers são reaproveitados.
+    const ResultadoSimulado& executar(uint64_t semente) {
+        reiniciar(semente);
+        if (ativos.size() > 1) agendar(0, TipoEvento::InicioRodada, 0);  // com um só, ele já venceu
+        return rodar();
+    }
+
+    // Estado da partida em andamento: só é válido dentro do callback de
+    // `salvar_entre_rodadas`.
+    void salvar_partida(checkpoint::Escrita& saida) const {
+        saida.natural(semente_atual);
+        saida.natural(static_cast<uint64_t>(rodada_atual));
+        saida.inteiro(agora);
+        saida.natural(ativos.size());
+        for (int id : ativos) saida.natural(static_cast<uint64_t>(id));
+        saida.natural(resultado.ordem_eliminacao.size());
+        for (int id : resultado.ordem_eliminacao) saida.natural(static_cast<uint64_t>(id));
+        saida.natural(resultado.rodadas_detalhe.size());
+        for (const RodadaSimulada& r : resultado.rodadas_detalhe) {
+            saida.inteiro(r.duracao_musica_ns);
+            saida.inteiro(r.duracao_resolucao_ns);
+        }
+        saida.gerador(gen);
+    }
+
+    // Continua a partida salva por `salvar_partida` até o fim.
+    const ResultadoSimulado& retomar(checkpoint::Leitura& entrada) {
+        reiniciar(entrada.natural());
+        rodada_atual = static_cast<int>(entrada.natural());
+        agora = entrada.inteiro();
+        ativos.resize(entrada.tamanho());
+        for (int& id : ativos) id = jogador_valido(entrada.natural());
+        resultado.ordem_eliminacao.resize(entrada.tamanho());
+        for (int& id : resultado.ordem_eliminacao) {
+            id = jogador_valido(entrada.natural());
+            elegiveis.remover(id);
+        }
+        resultado.rodadas_detalhe.resize(entrada.tamanho());
+        for (RodadaSimulada& r : resultado.rodadas_detalhe) {
+            r.duracao_musica_ns = entrada.inteiro();
+            r.duracao_resolucao_ns = entrada.inteiro();
+        }
+        resultado.rodadas = static_cast<int>(resultado.rodadas_detalhe.size());
+        entrada.gerador(gen);
+        agendar(agora, TipoEvento::InicioRodada, 0);
+        retomada = true;
+        return rodar();
+    }
+
+private:
+    enum class TipoEvento : uint8_t { InicioRodada, MusicaParou, Tentativa, PrazoSentar };
+
+    const ResultadoSimulado& rodar() {
+        while (!fila.empty()) {
+            std::pop_heap(fila.begin(), fila.end(), std::greater<Evento>());
+            Evento e = fila.back();
+            fila.pop_back();
+            agora = e.tempo;
+            if (e.tipo != TipoEvento::InicioRodada && (e.rodada != rodada_atual || resolvida)) {
+                continue;  // prazo ou tentativa atrasada de uma rodada já resolvida
+            }
+            if (e.tipo == TipoEvento::InicioRodada && checkpoints && checkpoints->pedido() && !retomada) {
+                salvar_checkpoint(*this);  // `agora` já é o instante do início da rodada
+            }
+            retomada = false;
+            switch (e.tipo) {
+            case TipoEvento::InicioRodada: iniciar_rodada(); break;
+            case TipoEvento::MusicaParou: parar_musica(); break;
+            case TipoEvento::Tentativa: tentar_sentar(e.jogador); break;
+            case TipoEvento::PrazoSentar: resolver_rodada(); break;
+            }
+        }
+
+        resultado.tempo_total_ns = agora;
+        if (ativos.size() == 1) resultado.vencedor = ativos[0];
+        return resultado;
+    }
+
+    int jogador_valido(uint64_t id) const {
+        if (id < 1 || id > static_cast<uint64_t>(config.num_jogadores)) {
+            throw std::runtime_error("checkpoint de outra configuração de jogo");
+        }
+        return static_cast<int>(id);
+    }
+
+    struct Evento {
+        int64_t tempo;
+        uint32_t sequencia;  // desempate determinístico entre eventos simultâneos
+        TipoEvento tipo;
+        int jogador;
+        int rodada;
+
+        bool operator>(const Evento& outro) const {
+            return tempo != outro.tempo ? tempo > outro.tempo : sequencia > outro.sequencia;
+        }
+    };
+
+    void reiniciar(uint64_t semente) {
+        gen.semear(semente);
+        semente_atual = semente;
+        resultado.vencedor = -1;
+        resultado.rodadas = 0;
+        resultado.ordem_eliminacao.clear();
+        resultado.rodadas_detalhe.clear();
+        resultado.tempo_total_ns = 0;
+        ativos.clear();
+        for (int i = 1; i <= config.num_jogadores; ++i) ativos.push_back(i);
+        elegiveis.construir(pesos);
+        fila.clear();
+        sequencia = 0;
+        agora = 0;
+        rodada_atual = 0;
+    }
+
+    void agendar(int64_t tempo, TipoEvento tipo, int jogador) {
+        fila.push_back(Evento{tempo, sequencia++, tipo, jogador, rodada_atual});
+        std::push_heap(fila.begin(), fila.end(), std::greater<Evento>());
+    }
+
+    void iniciar_rodada() {
+        ++rodada_atual;
+        resolvida = false;
+        cadeiras = static_cast<int>(ativos.size()) - 1;
+        permissoes = cadeiras;
+        tentativas = 0;
+        sentados.clear();
+        int64_t duracao = static_cast<int64_t>(gen.entre(config.musica_min_ms, config.musica_max_ms)) * 1'000'000;
+        resultado.rodadas_detalhe.push_back(RodadaSimulada{duracao, 0});
+        agendar(agora + duracao, TipoEvento::MusicaParou, 0);
+    }
+
+    void parar_musica() {
+        parada = agora;
+        if (eventos) eventos->abrir_rodada(semente_atual, static_cast<uint32_t>(rodada_atual), parada);
+        for (int id : ativos) {
+            double atraso_us = modelo.minimo_us + gen.exponencial(modelo.media_de(id));
+            agendar(agora + static_cast<int64_t>(atraso_us * 1000.0), TipoEvento::Tentativa, id);
+        }
+        agendar(agora + static_cast<int64_t>(config.espera_sentar_ms) * 1'000'000, TipoEvento::PrazoSentar, 0);
+    }
+
+    void tentar_sentar(int jogador) {
+        if (permissoes > 0) {
+            --permissoes;
+            sentados.push_back(jogador);
+            if (eventos) eventos->registrar(jogador, static_cast<int>(sentados.size()), agora);
+        } else if (eventos) {
+            eventos->registrar(jogador, 0, agora);
+        }
+        if (++tentativas == static_cast<int>(ativos.size())) {
+            resolver_rodada();
+        }
+    }
+
+    void resolver_rodada() {
+        // Mesmo esquema do Coordenador: os sentados saem da árvore só
+        // durante o sorteio ponderado entre quem ficou sem cadeira.
+        for (int id : sentados) elegiveis.remover(id);
+
+        resultado.rodadas_detalhe.back().duracao_resolucao_ns = agora - parada;
+        ++resultado.rodadas;
+        if (elegiveis.total() > 0) {
+            int eliminado = static_cast<int>(elegiveis.sortear(gen));
+            elegiveis.remover(eliminado);
+            ativos.erase(std::find(ativos.begin(), ativos.end(), eliminado));
+            resultado.ordem_eliminacao.push_back(eliminado);
+        }
+        for (int id : sentados) elegiveis.definir(id, pesos[id]);
+
+        resolvida = true;
+        if (ativos.size() > 1) {
+            agendar(agora + static_cast<int64_t>(config.pausa_rodada_ms) * 1'000'000, TipoEvento::InicioRodada, 0);
+        }
+    }
+
+    ConfigJogo config;
+    ModeloReacao modelo;
+    GeradorLote gen;
+    uint64_t semente_atual = 0;
+    CodificadorEventos* eventos = nullptr;
+    GravadorCheckpoint* checkpoints = nullptr;
+    std::function<void(const MotorEventos&)> salvar_checkpoint;
+    bool retomada = false;  // não salva de novo na rodada em que acabou de retomar
+    std::vector<uint64_t> pesos;
+    AmostradorPonderado elegiveis;  // pesos dos jogadores ativos
+
+    std::vector<Evento> fila;  // heap mínimo por (tempo, sequência)
+    uint32_t sequencia = 0;
+    int64_t agora = 0;
+    int64_t parada = 0;
+    int rodada_atual = 0;
+    bool resolvida = false;
+    int cadeiras = 0;
+    int permissoes = 0;
+    int tentativas = 0;
+
+    std::vector<int> ativos;
+    std::vector<int> sentados;
+    ResultadoSimulado resultado;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdlib>
+
+// Leitura simples da linha de comando: `programa [modo] [--chave valor] [--flag]`.
+class Opcoes {
+public:
+    Opcoes(int argc, char** argv) {
+        programa = argc > 0 ? argv[0] : "";
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--", 0) == 0) {
+                std::string chave = arg.substr(2);
+                if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                    valores[chave] = argv[++i];
+                } else {
+                    valores[chave] = "";
+                }
+            } else {
+                posicionais.push_back(arg);
+            }
+        }
+    }
+
+    bool tem(const std::string& chave) const { return valores.count(chave) > 0; }
+
+    std::string texto(const std::string& chave, const std::string& padrao = "") const {
+        auto it = valores.find(chave);
+        return it == valores.end() ? padrao : it->second;
+    }
+
+    long long inteiro(const std::string& chave, long long padrao) const {
+        auto it = valores.find(chave);
+        return it == valores.end() || it->second.empty() ? padrao : std::atoll(it->second.c_str());
+    }
+
+    double real(const std::string& chave, double padrao) const {
+        auto it = valores.find(chave);
+        return it == valores.end() || it->second.empty() ? padrao : std::atof(it->second.c_str());
+    }
+
+    std::string modo() const { return posicionais.empty() ? "" : posicionais[0]; }
+    const std::string& get_programa() const { return programa; }
+
+    // Diretório do executável, usado para localizar os programas auxiliares.
+    std::string diretorio_programa() const {
+        auto pos = programa.find_last_of('/');
+        return pos == std::string::npos ? "." : programa.substr(0, pos);
+    }
+
+private:
+    std::string programa;
+    std::vector<std::string> posicionais;
+    std::map<std::string, std::string> valores;
+};
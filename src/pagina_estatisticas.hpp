@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "seqlock.hpp"
+
+/*
+ * Página de estatísticas ao vivo em memória compartilhada (`shm_open`, ou
+ * seja, /dev/shm). O jogo publica com um seqlock e monitores externos mapeiam
+ * a página só para leitura: cada leitura são algumas cargas de memória, sem
+ * chamada de sistema e sem nenhum efeito nas threads do jogo.
+ *
+ * Layout fixo: cabeçalho de 64 bytes (mágica, versão, pid do escritor) e, na
+ * linha de cache seguinte, o seqlock com `EstatisticasAoVivo`. Um monitor em
+ * outra linguagem lê a sequência (offset 64), as 8 palavras de 64 bits que
+ * seguem e a sequência de novo, e só aceita a leitura se ela for par e não
+ * tiver mudado.
+ */
+struct EstatisticasAoVivo {
+    uint64_t rodada = 0;               // rodada atual (a partir de 1; 0 = antes da primeira)
+    uint64_t jogadores_ativos = 0;
+    uint64_t cadeiras = 0;
+    uint64_t duracao_ultima_rodada_us = 0;
+    uint64_t partidas_concluidas = 0;
+    uint64_t rodadas_concluidas = 0;   // somando todas as partidas
+    uint64_t atualizado_ns = 0;        // CLOCK_REALTIME da última publicação
+    uint64_t encerrado = 0;            // 1 quando o escritor terminou
+};
+
+namespace pagina {
+
+constexpr char MAGICA[8] = {'C', 'A', 'D', 'S', 'T', 'A', 'T', '1'};
+constexpr uint32_t VERSAO = 1;
+
+struct Cabecalho {
+    char magica[8];
+    uint32_t versao;
+    uint32_t pid;
+    char reservado[48];
+};
+static_assert(sizeof(Cabecalho) == 64);
+
+struct Layout {
+    Cabecalho cabecalho;
+    alignas(64) Seqlock<EstatisticasAoVivo> estatisticas;
+};
+
+}  // namespace pagina
+
+// Cria (ou recria) a página e publica nela. Um escritor por página; ao ser
+// destruída, marca `encerrado` e remove o nome (monitores já conectados
+// continuam lendo o último valor).
+class PaginaEstatisticas {
+public:
+    explicit PaginaEstatisticas(const std::string& nome) : nome(nome) {
+        int fd = ::shm_open(nome.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("página " + nome + ": " + std::strerror(errno));
+        if (::ftruncate(fd, sizeof(pagina::Layout)) < 0) {
+            int erro = errno;
+            ::close(fd);
+            throw std::runtime_error("página " + nome + ": " + std::strerror(erro));
+        }
+        void* mapa = ::mmap(nullptr, sizeof(pagina::Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapa == MAP_FAILED) throw std::runtime_error("página " + nome + ": " + std::strerror(errno));
+
+        layout = new (mapa) pagina::Layout{};
+        std::memcpy(layout->cabecalho.magica, pagina::MAGICA, sizeof(pagina::MAGICA));
+        layout->cabecalho.versao = pagina::VERSAO;
+        layout->cabecalho.pid = static_cast<uint32_t>(::getpid());
+    }
+
+    ~PaginaEstatisticas() {
+        atual.encerrado = 1;
+        publicar();
+        ::munmap(layout, sizeof(pagina::Layout));
+        ::shm_unlink(nome.c_str());
+    }
+
+    PaginaEstatisticas(const PaginaEstatisticas&) = delete;
+    PaginaEstatisticas& operator=(const PaginaEstatisticas&) = delete;
+
+    // Quem escreve altera os campos e publica; o carimbo de tempo é posto aqui.
+    EstatisticasAoVivo& valores() { return atual; }
+
+    void publicar() {
+        timespec agora;
+        ::clock_gettime(CLOCK_REALTIME, &agora);
+        atual.atualizado_ns = static_cast<uint64_t>(agora.tv_sec) * 1'000'000'000ull + static_cast<uint64_t>(agora.tv_nsec);
+        layout->estatisticas.escrever(atual);
+    }
+
+private:
+    std::string nome;
+    pagina::Layout* layout = nullptr;
+    EstatisticasAoVivo atual;
+};
+
+// Mapeia uma página existente só para leitura.
+class LeitorPagina {
+public:
+    explicit LeitorPagina(const std::string& nome) {
+        int fd = ::shm_open(nome.c_str(), O_RDONLY, 0);
+        if (fd < 0) throw std::runtime_error("página " + nome + ": " + std::strerror(errno));
+        struct stat info;
+        if (::fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(pagina::Layout)) {
+            ::close(fd);
+            throw std::runtime_error("página " + nome + ": ainda não inicializada ou de outro formato");
+        }
+        void* mapa = ::mmap(nullptr, sizeof(pagina::Layout), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapa == MAP_FAILED) throw std::runtime_error("página " + nome + ": " + std::strerror(errno));
+        layout = static_cast<const pagina::Layout*>(mapa);
+        if (std::memcmp(layout->cabecalho.magica, pagina::MAGICA, sizeof(pagina::MAGICA)) != 0 ||
+            layout->cabecalho.versao != pagina::VERSAO) {
+            ::munmap(mapa, sizeof(pagina::Layout));
+            throw std::runtime_error("página " + nome + ": formato desconhecido");
+        }
+    }
+
+    ~LeitorPagina() { ::munmap(const_cast<pagina::Layout*>(layout), sizeof(pagina::Layout)); }
+
+    LeitorPagina(const LeitorPagina&) = delete;
+    LeitorPagina& operator=(const LeitorPagina&) = delete;
+
+    EstatisticasAoVivo ler() const { return layout->estatisticas.ler(); }
+    uint64_t get_versao() const { return layout->estatisticas.get_versao(); }
+    uint32_t get_pid() const { return layout->cabecalho.pid; }
+
+private:
+    const pagina::Layout* layout = nullptr;
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "aleatorio.hpp"
+
+/*
+ * Partidas do motor em pool: cada partida é uma instância independente, e os
+ * jogadores não têm thread dedicada. Quem executa a partida é um único worker
+ * do pool, que toca a música e despacha os jogadores em ordem de reação. Como
+ * ninguém disputa a partida com o worker, as cadeiras livres são um contador
+ * simples, sem semáforo nem `music_cv`.
+ */
+
+enum class PoliticaReacao : uint8_t {
+    Aleatoria = 0,   // cada rodada sorteia uma nova ordem de reação
+    Persistente = 1, // cada jogador tem uma velocidade própria, com ruído por rodada
+};
+
+// Versão das regras e das políticas de reação do motor em pool. Incrementar
+// sempre que a mesma especificação puder dar outro resultado: invalida o que
+// estiver guardado no CacheResultados.
+constexpr uint32_t VERSAO_REGRAS_PARTIDA = 1;
+
+// Especificação de uma partida. O layout é fixo porque a mesma estrutura
+// trafega no protocolo do serviço de jogos.
+struct EspecJogo {
+    uint32_t id = 0;              // identificador do pedido, devolvido no resultado
+    uint32_t num_jogadores = 4;
+    uint64_t semente = 0;
+    uint32_t musica_us = 0;       // duração da música em cada rodada
+    uint8_t politica = 0;         // PoliticaReacao
+    uint8_t tam_cronograma = 0;
+    uint8_t cronograma[10] = {};  // cadeiras removidas por rodada; a última entrada se repete
+
+    int remocoes_na_rodada(int rodada) const {
+        if (tam_cronograma == 0) return 1;
+        int indice = std::min<int>(rodada, tam_cronograma - 1);
+        return std::max<int>(1, cronograma[indice]);
+    }
+};
+static_assert(sizeof(EspecJogo) == 32, "EspecJogo trafega no protocolo com 32 bytes");
+
+// "1,1,2" -> cronograma de remoção de cadeiras por rodada.
+inline void ler_cronograma(const std::string& texto, EspecJogo& espec) {
+    std::stringstream ss(texto);
+    std::string item;
+    espec.tam_cronograma = 0;
+    while (std::getline(ss, item, ',') && espec.tam_cronograma < sizeof(espec.cronograma)) {
+        espec.cronograma[espec.tam_cronograma++] = static_cast<uint8_t>(std::stoi(item));
+    }
+}
+
+struct ResultadoCompacto {
+    uint32_t id = 0;
+    uint32_t vencedor = 0;
+    uint32_t rodadas = 0;
+    uint32_t assinatura = 0;      // hash FNV-1a da ordem de eliminação
+};
+static_assert(sizeof(ResultadoCompacto) == 16, "ResultadoCompacto trafega no protocolo com 16 bytes");
+
+class Partida {
+public:
+    explicit Partida(const EspecJogo& espec)
+        : espec(espec), gen(espec.semente) {
+        int n = std::max<int>(1, espec.num_jogadores);
+        for (int i = 1; i <= n; ++i) {
+            jogadores_ativos.push_back(i);
+        }
+        if (espec.politica == static_cast<uint8_t>(PoliticaReacao::Persistente)) {
+            velocidade.resize(n + 1);
+            for (int i = 1; i <= n; ++i) velocidade[i] = gen.abaixo(1001);
+        }
+        resultado.id = espec.id;
+        resultado.assinatura = 2166136261u;
+    }
+
+    bool terminou() const { return jogadores_ativos.size() <= 1; }
+
+    void iniciar_rodada() {
+        int ativos = static_cast<int>(jogadores_ativos.size());
+        cadeiras = std::clamp(ativos - espec.remocoes_na_rodada(resultado.rodadas), 1, ativos - 1);
+        livres = cadeiras;
+    }
+
+    // Toca a música pela duração da especificação, ocupando o worker.
+    void tocar_musica() {
+        if (espec.musica_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(espec.musica_us));
+    }
+
+    // Os jogadores estacionados reagem à parada da música: quem reage primeiro
+    // pega uma cadeira livre primeiro; quando acabam, os demais ficam sem.
+    void despachar_jogadores() {
+        sortear_ordem_reacao();
+        sem_cadeira.clear();
+        for (int id : ordem_reacao) {
+            if (livres > 0) {
+                --livres;
+            } else {
+                sem_cadeira.push_back(id);
+            }
+        }
+    }
+
+    void resolver_rodada() {
+        for (int id : sem_cadeira) {
+            eliminar_jogador(id);
+        }
+        ++resultado.rodadas;
+        if (terminou() && !jogadores_ativos.empty()) {
+            resultado.vencedor = static_cast<uint32_t>(jogadores_ativos[0]);
+        }
+    }
+
+    ResultadoCompacto executar() {
+        while (!terminou()) {
+            iniciar_rodada();
+            tocar_musica();
+            despachar_jogadores();
+            resolver_rodada();
+        }
+        return resultado;
+    }
+
+    const ResultadoCompacto& get_resultado() const { return resultado; }
+    const EspecJogo& get_espec() const { return espec; }
+    const std::vector<int>& get_jogadores_ativos() const { return jogadores_ativos; }
+
+private:
+    void sortear_ordem_reacao() {
+        ordem_reacao = jogadores_ativos;
+        if (velocidade.empty()) {
+            gen.embaralhar(ordem_reacao);
+            return;
+        }
+        reacao.resize(velocidade.size());
+        for (int id : ordem_reacao) reacao[id] = velocidade[id] + gen.abaixo(251);
+        std::sort(ordem_reacao.begin(), ordem_reacao.end(), [&](int a, int b) {
+            return reacao[a] != reacao[b] ? reacao[a] < reacao[b] : a < b;
+        });
+    }
+
+    void eliminar_jogador(int jogador_id) {
+        jogadores_ativos.erase(std::remove(jogadores_ativos.begin(), jogadores_ativos.end(), jogador_id),
+                               jogadores_ativos.end());
+        for (int desloc = 0; desloc < 32; desloc += 8) {
+            resultado.assinatura ^= (static_cast<uint32_t>(jogador_id) >> desloc) & 0xffu;
+            resultado.assinatura *= 16777619u;
+        }
+    }
+
+    EspecJogo espec;
+    GeradorLote gen;
+    int cadeiras = 0;
+    int livres = 0;  // cadeiras ainda não ocupadas na rodada
+
+    std::vector<int> jogadores_ativos;
+    std::vector<int> ordem_reacao;
+    std::vector<int> sem_cadeira;
+    std::vector<uint32_t> velocidade;
+    std::vector<uint32_t> reacao;
+    ResultadoCompacto resultado;
+};
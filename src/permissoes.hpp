@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/*
+ * Permissões (cadeiras livres) numa única palavra atômica, para quem precisa
+ * de várias de uma vez.
+ *
+ * Com o `std::counting_semaphore`, pegar k cadeiras são k `try_acquire()`
+ * separados: quem consegue só parte precisa devolver o que pegou, e duas
+ * equipes que pegam metade cada uma podem se desfazer uma à outra para sempre
+ * (livelock), sem nenhuma sentar. Aqui `tentar_pegar(k)` lê o contador e, se
+ * houver k livres, troca por `livres - k` com um único CAS: ou leva as k ou
+ * não leva nenhuma. Nunca existe posse parcial, então não há o que desfazer.
+ * Um CAS só falha porque outra thread mudou o contador, ou seja, alguém
+ * progrediu (lock-free).
+ *
+ * `tentar_pegar_ate(k, limite)` espera com prazo, como o `try_acquire_until`
+ * do semáforo. A espera é um eventcount: quem desiste de girar lê o `sinal`
+ * (32 bits), se registra em `esperando`, confere o contador de novo e dorme
+ * num futex com prazo absoluto no CLOCK_MONOTONIC (o mesmo do
+ * `steady_clock`). Quem devolve soma ao contador e, só se houver alguém
+ * esperando, avança o `sinal` e acorda até k threads (nenhuma precisa de
+ * menos de uma permissão; com pedidos de tamanhos misturados, um acordado que
+ * não cabe volta a dormir até a próxima devolução ou o prazo). Sem ninguém
+ * esperando, devolver é só um
+ * `fetch_add`. Registro e conferência são seq_cst dos dois lados: ou quem
+ * espera vê a permissão, ou quem devolve vê quem espera.
+ */
+class PermissoesAtomicas {
+public:
+    explicit PermissoesAtomicas(int64_t iniciais = 0) : livres(iniciais) {}
+
+    // Tudo ou nada: true se levou as `k` permissões.
+    bool tentar_pegar(int64_t k = 1) {
+        int64_t atual = livres.load(std::memory_order_relaxed);
+        while (atual >= k) {
+            if (livres.compare_exchange_weak(atual, atual - k, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Tudo ou nada, esperando até `limite` por permissões suficientes.
+    bool tentar_pegar_ate(int64_t k, std::chrono::steady_clock::time_point limite) {
+        for (int giro = 0; giro < GIROS; ++giro) {
+            if (tentar_pegar(k)) return true;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+        while (true) {
+            uint32_t visto = sinal.load(std::memory_order_acquire);
+            if (tentar_pegar(k)) return true;
+            if (std::chrono::steady_clock::now() >= limite) return false;
+            esperando.fetch_add(1, std::memory_order_seq_cst);
+            bool pegou = livres.load(std::memory_order_seq_cst) >= k && tentar_pegar(k);
+            if (!pegou) dormir(visto, limite);
+            esperando.fetch_sub(1, std::memory_order_relaxed);
+            if (pegou) return true;
+        }
+    }
+
+    bool tentar_pegar_por(int64_t k, std::chrono::nanoseconds prazo) {
+        return tentar_pegar_ate(k, std::chrono::steady_clock::now() + prazo);
+    }
+
+    void devolver(int64_t k = 1) {
+        livres.fetch_add(k, std::memory_order_seq_cst);
+        acordar(k);
+    }
+
+    // Descarta o que sobrou e deixa exatamente `n` livres (início de rodada).
+    void redefinir(int64_t n) {
+        livres.store(n, std::memory_order_seq_cst);
+        acordar(n);
+    }
+
+    int64_t disponiveis() const { return livres.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int GIROS = 64;
+
+    void acordar(int64_t k) {
+        if (k <= 0 || esperando.load(std::memory_order_seq_cst) == 0) return;
+        sinal.fetch_add(1, std::memory_order_release);
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sinal), FUTEX_WAKE_PRIVATE,
+                  static_cast<int>(k < INT_MAX ? k : INT_MAX), nullptr, nullptr, 0);
+    }
+
+    // Dorme enquanto `sinal` valer `visto`, no máximo até `limite`.
+    void dormir(uint32_t visto, std::chrono::steady_clock::time_point limite) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(limite.time_since_epoch()).count();
+        timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+        ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(&sinal), FUTEX_WAIT_BITSET_PRIVATE, visto, &ts, nullptr,
+                  FUTEX_BITSET_MATCH_ANY);
+    }
+
+    alignas(64) std::atomic<int64_t> livres;
+    std::atomic<uint32_t> sinal{0};
+    std::atomic<uint32_t> esperando{0};
+};
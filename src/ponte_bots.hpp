@@ -0,0 +1,233 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "jogo.hpp"
+#include "protocolo.hpp"
+
+/*
+ * Ponte entre o jogo e jogadores que rodam em outros processos.
+ *
+ * Do ponto de vista do JogoDasCadeiras a ponte é só mais um jogador esperando
+ * a música parar na `music_cv`, mas que representa vários ids ao mesmo tempo.
+ * Quando a música para, ela avisa todos os bots (um lote por conexão), coleta
+ * os pedidos de cadeira com `epoll` e tenta sentar cada um no semáforo do jogo,
+ * na ordem em que os pedidos chegaram.
+ */
+class PonteBots {
+public:
+    PonteBots(JogoDasCadeiras& jogo, std::string caminho, int primeiro_id, int quantidade)
+        : jogo(jogo), caminho(std::move(caminho)), primeiro_id(primeiro_id), quantidade(quantidade),
+          dono(quantidade, -1), avisado(quantidade, false), respondido(quantidade, false) {}
+
+    ~PonteBots() {
+        for (auto& c : conexoes) ::close(c.get_fd());
+        if (epoll_fd >= 0) ::close(epoll_fd);
+        if (escuta_fd >= 0) {
+            ::close(escuta_fd);
+            ::unlink(caminho.c_str());
+        }
+    }
+
+    void abrir() {
+        escuta_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (escuta_fd < 0) throw std::runtime_error("socket: " + std::string(std::strerror(errno)));
+        ::unlink(caminho.c_str());
+        sockaddr_un endereco = endereco_unix(caminho);
+        if (::bind(escuta_fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 ||
+            ::listen(escuta_fd, 64) < 0) {
+            throw std::runtime_error("bind/listen em " + caminho + ": " + std::strerror(errno));
+        }
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    }
+
+    // Aceita conexões até que todos os ids externos tenham um processo dono.
+    // O prazo vale também para o Registro: quem conecta e não fala nada não
+    // segura a partida.
+    void aguardar_registros(std::chrono::milliseconds prazo) {
+        auto limite = std::chrono::steady_clock::now() + prazo;
+        auto restante_ms = [&] {
+            return static_cast<int>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                             limite - std::chrono::steady_clock::now()).count()));
+        };
+        int registrados = 0;
+        std::vector<Mensagem> recebidas;
+        while (registrados < quantidade) {
+            pollfd escuta{escuta_fd, POLLIN, 0};
+            int restante = restante_ms();
+            if (restante <= 0 || ::poll(&escuta, 1, restante) == 0) {
+                throw std::runtime_error("tempo esgotado esperando os bots se registrarem");
+            }
+            int fd = ::accept4(escuta_fd, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("accept: " + std::string(std::strerror(errno)));
+            }
+
+            CanalMensagens canal(fd);
+            recebidas.clear();
+            while (recebidas.empty()) {
+                pollfd leitura{fd, POLLIN, 0};
+                restante = restante_ms();
+                if (restante <= 0 || ::poll(&leitura, 1, restante) <= 0 || !canal.receber(recebidas)) break;
+            }
+            if (recebidas.empty() || recebidas[0].tipo != static_cast<uint8_t>(TipoMensagem::Registro) ||
+                static_cast<int32_t>(recebidas[0].valor) <= 0) {
+                ::close(fd);
+                continue;
+            }
+
+            int indice = static_cast<int>(conexoes.size());
+            int pedidos = static_cast<int>(recebidas[0].valor);
+            for (int i = 0; i < pedidos && registrados < quantidade; ++i, ++registrados) {
+                dono[registrados] = indice;
+                canal.enfileirar(criar_mensagem(TipoMensagem::BoasVindas, primeiro_id + registrados));
+            }
+            // Socket não bloqueante; as boas-vindas são poucas, insiste até saírem.
+            while (canal.tem_pendentes() && canal.descarregar()) {}
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.u32 = static_cast<uint32_t>(indice);
+            ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+            conexoes.push_back(canal);
+        }
+    }
+
+    // Corpo da thread da ponte: uma iteração por rodada até o fim do jogo.
+    void executar() {
+        std::vector<epoll_event> eventos(conexoes.size() + 1);
+        std::vector<Mensagem> recebidas;
+        std::vector<char> sujas(conexoes.size(), false);
+        int rodada_vista = 0;
+
+        while (true) {
+            rodada_vista = jogo.aguardar_musica_parar(rodada_vista);
+            if (rodada_vista == 0) break;
+
+            int pendentes = 0;
+            std::fill(respondido.begin(), respondido.end(), false);
+            for (int i = 0; i < quantidade; ++i) {
+                int id = primeiro_id + i;
+                if (!jogo.esta_ativo(id)) {
+                    avisar_eliminacao(i);
+                    continue;
+                }
+                conexoes[dono[i]].enfileirar(criar_mensagem(TipoMensagem::MusicaParou, id, rodada_vista));
+                ++pendentes;
+            }
+
+            auto envio = RelogioRapido::now();
+            for (auto& c : conexoes) c.descarregar();
+
+            auto limite = jogo.get_prazo_rodada();  // o mesmo prazo do coordenador
+            while (pendentes > 0) {
+                auto restante = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    limite - std::chrono::steady_clock::now());
+                if (restante.count() <= 0) break;
+
+                int prontos = ::epoll_wait(epoll_fd, eventos.data(), static_cast<int>(eventos.size()),
+                                           static_cast<int>(restante.count()));
+                if (prontos < 0 && errno != EINTR) break;
+
+                for (int e = 0; e < prontos; ++e) {
+                    uint32_t indice = eventos[e].data.u32;
+                    recebidas.clear();
+                    conexoes[indice].receber(recebidas);
+                    auto chegada = RelogioRapido::now();
+
+                    for (const Mensagem& m : recebidas) {
+                        if (m.tipo != static_cast<uint8_t>(TipoMensagem::PedidoCadeira) ||
+                            m.rodada != static_cast<uint32_t>(rodada_vista) || !pedido_valido(m.jogador, indice)) {
+                            continue;
+                        }
+                        respondido[m.jogador - static_cast<uint32_t>(primeiro_id)] = true;
+                        latencias_ns.push_back(
+                            std::chrono::duration_cast<std::chrono::nanoseconds>(chegada - envio).count());
+                        bool sentou = jogo.tentar_sentar(static_cast<int>(m.jogador), rodada_vista);
+                        conexoes[indice].enfileirar(
+                            criar_mensagem(TipoMensagem::Resposta, m.jogador, m.rodada, sentou ? 1 : 0));
+                        sujas[indice] = true;
+                        --pendentes;
+                    }
+                }
+
+                // Respostas coalescidas: uma escrita por conexão por volta do epoll.
+                for (size_t i = 0; i < conexoes.size(); ++i) {
+                    if (sujas[i]) {
+                        conexoes[i].descarregar();
+                        sujas[i] = false;
+                    }
+                }
+            }
+        }
+    }
+
+    // Avisa eliminações que ainda não chegaram aos bots e anuncia o vencedor.
+    void encerrar(int vencedor) {
+        for (int i = 0; i < quantidade; ++i) {
+            if (!jogo.esta_ativo(primeiro_id + i)) avisar_eliminacao(i);
+        }
+        for (auto& c : conexoes) {
+            c.enfileirar(criar_mensagem(TipoMensagem::FimDeJogo, 0, 0, static_cast<uint32_t>(vencedor)));
+            // O socket é não bloqueante; o lote final é pequeno, mas insiste até sair inteiro.
+            while (c.tem_pendentes() && c.descarregar()) {}
+        }
+    }
+
+    void exibir_latencias() const {
+        if (latencias_ns.empty()) return;
+        std::vector<long long> ordenadas = latencias_ns;
+        std::sort(ordenadas.begin(), ordenadas.end());
+        auto percentil = [&](double p) {
+            return ordenadas[static_cast<size_t>(p * (ordenadas.size() - 1))] / 1000.0;
+        };
+        std::cout << "\nLatência ida-e-volta dos bots (" << ordenadas.size() << " pedidos, µs): "
+                  << "min " << percentil(0.0) << " | p50 " << percentil(0.5)
+                  << " | p99 " << percentil(0.99) << " | max " << percentil(1.0) << "\n";
+    }
+
+    const std::vector<long long>& get_latencias_ns() const { return latencias_ns; }
+
+private:
+    // O bot só pede por ids que a ponte lhe deu, ainda ativos, uma vez por
+    // rodada; o resto é descartado sem tocar no jogo.
+    bool pedido_valido(uint32_t jogador, uint32_t conexao) const {
+        if (jogador < static_cast<uint32_t>(primeiro_id)) return false;
+        uint32_t i = jogador - static_cast<uint32_t>(primeiro_id);
+        return i < static_cast<uint32_t>(quantidade) && dono[i] == static_cast<int>(conexao) && !respondido[i] &&
+               jogo.esta_ativo(static_cast<int>(jogador));
+    }
+
+    void avisar_eliminacao(int indice) {
+        if (avisado[indice]) return;
+        avisado[indice] = true;
+        auto& canal = conexoes[dono[indice]];
+        canal.enfileirar(criar_mensagem(TipoMensagem::Eliminado, primeiro_id + indice));
+    }
+
+    JogoDasCadeiras& jogo;
+    std::string caminho;
+    int primeiro_id;
+    int quantidade;
+    int escuta_fd = -1;
+    int epoll_fd = -1;
+    std::vector<CanalMensagens> conexoes;
+    std::vector<int> dono;       // índice da conexão que hospeda cada id externo
+    std::vector<bool> avisado;   // eliminação já comunicada ao bot
+    std::vector<bool> respondido;  // id que já pediu cadeira na rodada atual
+    std::vector<long long> latencias_ns;
+};
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include "partida.hpp"
+
+// Como os jogadores de uma partida ficam estacionados enquanto a música toca.
+enum class ModoEspera {
+    CondicaoMusica,  // o worker dorme (`sleep_for`) enquanto a música da partida toca; uma partida por vez
+    EventFd,         // o worker faz `epoll` sobre um `eventfd` por partida; várias partidas por worker
+};
+
+/*
+ * Maestro do modo EventFd: guarda o instante em que a música de cada partida
+ * deve parar e, quando ele chega, escreve no `eventfd` da partida. É o papel
+ * do coordenador, compartilhado por todas as partidas em andamento.
+ */
+class Maestro {
+public:
+    Maestro() : thread(&Maestro::reger, this) {}
+
+    ~Maestro() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ativo = false;
+        }
+        cv.notify_one();
+        thread.join();
+    }
+
+    void agendar(std::chrono::steady_clock::time_point parada, int evento_fd) {
+        bool mais_cedo;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            mais_cedo = agenda.empty() || parada < agenda.top().first;
+            agenda.emplace(parada, evento_fd);
+        }
+        if (mais_cedo) cv.notify_one();
+    }
+
+    static void sinalizar(int evento_fd) {
+        uint64_t um = 1;
+        [[maybe_unused]] ssize_t n = ::write(evento_fd, &um, sizeof(um));
+    }
+
+private:
+    using Parada = std::pair<std::chrono::steady_clock::time_point, int>;
+
+    void reger() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (ativo) {
+            if (agenda.empty()) {
+                cv.wait(lock);
+                continue;
+            }
+            auto [parada, evento_fd] = agenda.top();
+            if (std::chrono::steady_clock::now() < parada) {
+                cv.wait_until(lock, parada);
+                continue;
+            }
+            agenda.pop();
+            sinalizar(evento_fd);
+        }
+    }
+
+    std::priority_queue<Parada, std::vector<Parada>, std::greater<Parada>> agenda;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool ativo = true;
+    std::thread thread;
+};
+
+/*
+ * Pool de workers compartilhado pelas partidas do motor em pool.
+ *
+ * Um lote submetido é quebrado em blocos; cada worker retira um bloco inteiro
+ * da fila, executa as partidas e entrega os resultados do bloco de uma vez.
+ * Assim o custo de fila e de entrega é pago por bloco, não por partida.
+ */
+class PoolPartidas {
+public:
+    using Entrega = std::function<void(std::vector<ResultadoCompacto>&&)>;
+
+    explicit PoolPartidas(int num_workers, ModoEspera modo = ModoEspera::CondicaoMusica,
+                          size_t partidas_por_worker = 256)
+        : modo(modo), partidas_por_worker(std::max<size_t>(1, partidas_por_worker)) {
+        if (num_workers <= 0) num_workers = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        if (modo == ModoEspera::EventFd) maestro = std::make_unique<Maestro>();
+        for (int i = 0; i < num_workers; ++i) {
+            if (modo == ModoEspera::EventFd) {
+                workers.emplace_back(&PoolPartidas::trabalhar_com_eventos, this);
+            } else {
+                workers.emplace_back(&PoolPartidas::trabalhar, this);
+            }
+        }
+    }
+
+    ~PoolPartidas() {
+        {
+            std::lock_guard<std::mutex> lock(fila_mutex);
+            ativo = false;
+        }
+        fila_cv.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    PoolPartidas(const PoolPartidas&) = delete;
+    PoolPartidas& operator=(const PoolPartidas&) = delete;
+
+    void submeter(std::vector<EspecJogo> lote, Entrega entrega, size_t tamanho_bloco = 64) {
+        submeter(std::move(lote), std::make_shared<Entrega>(std::move(entrega)), tamanho_bloco);
+    }
+
+    // Mesma coisa com uma entrega compartilhada entre submissões, para quem
+    // submete partidas uma a uma e não quer alocar uma entrega por partida.
+    void submeter(std::vector<EspecJogo> lote, std::shared_ptr<Entrega> destino, size_t tamanho_bloco = 64) {
+        {
+            std::lock_guard<std::mutex> lock(fila_mutex);
+            for (size_t inicio = 0; inicio < lote.size(); inicio += tamanho_bloco) {
+                size_t fim = std::min(lote.size(), inicio + tamanho_bloco);
+                fila.push_back(Bloco{std::vector<EspecJogo>(lote.begin() + inicio, lote.begin() + fim), destino});
+            }
+        }
+        fila_cv.notify_all();
+    }
+
+    size_t get_num_workers() const { return workers.size(); }
+    ModoEspera get_modo() const { return modo; }
+
+private:
+    struct Bloco {
+        std::vector<EspecJogo> jogos;
+        std::shared_ptr<Entrega> entrega;
+    };
+
+    // Retira um bloco da fila; com `bloquear` falso, volta vazio se não houver nenhum.
+    bool retirar_bloco(Bloco& bloco, bool bloquear) {
+        std::unique_lock<std::mutex> lock(fila_mutex);
+        if (bloquear) {
+            fila_cv.wait(lock, [&] { return !ativo || !fila.empty(); });
+        }
+        if (fila.empty()) return false;
+        bloco = std::move(fila.front());
+        fila.pop_front();
+        return true;
+    }
+
+    void trabalhar() {
+        std::vector<ResultadoCompacto> resultados;
+        Bloco bloco;
+        while (retirar_bloco(bloco, true)) {
+            resultados.clear();
+            resultados.reserve(bloco.jogos.size());
+            for (const EspecJogo& espec : bloco.jogos) {
+                Partida partida(espec);
+                resultados.push_back(partida.executar());
+            }
+            (*bloco.entrega)(std::move(resultados));
+            resultados = {};
+        }
+    }
+
+    // Bloco cujas partidas estão espalhadas pelo laço de eventos de um worker.
+    struct BlocoEmAndamento {
+        Bloco bloco;
+        std::vector<ResultadoCompacto> resultados;
+        size_t restantes;
+    };
+
+    struct PartidaHospedada {
+        Partida partida;
+        int evento_fd;
+        BlocoEmAndamento* origem;
+    };
+
+    // Inicia uma rodada e agenda a parada da música; sem música, o `eventfd`
+    // é sinalizado na hora e a rodada é resolvida na próxima volta do laço.
+    void tocar_rodada(PartidaHospedada& h) {
+        h.partida.iniciar_rodada();
+        uint32_t musica_us = h.partida.get_espec().musica_us;
+        if (musica_us == 0) {
+            Maestro::sinalizar(h.evento_fd);
+        } else {
+            maestro->agendar(std::chrono::steady_clock::now() + std::chrono::microseconds(musica_us), h.evento_fd);
+        }
+    }
+
+    void trabalhar_com_eventos() {
+        int epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        std::vector<epoll_event> eventos(256);
+        std::deque<BlocoEmAndamento> blocos;
+        size_t hospedadas = 0;
+
+        while (true) {
+            // Completa a capacidade do worker; só bloqueia na fila se não houver
+            // nenhuma partida em andamento.
+            while (hospedadas < partidas_por_worker) {
+                Bloco bloco;
+                if (!retirar_bloco(bloco, hospedadas == 0)) break;
+                blocos.push_back(BlocoEmAndamento{std::move(bloco), {}, 0});
+                BlocoEmAndamento& andamento = blocos.back();
+                andamento.restantes = andamento.bloco.jogos.size();
+                andamento.resultados.reserve(andamento.restantes);
+                for (const EspecJogo& espec : andamento.bloco.jogos) {
+                    auto* h = new PartidaHospedada{Partida(espec), ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC),
+                                                   &andamento};
+                    epoll_event ev{};
+                    ev.events = EPOLLIN;
+                    ev.data.ptr = h;
+                    ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, h->evento_fd, &ev);
+                    ++hospedadas;
+                    if (h->partida.terminou()) {
+                        Maestro::sinalizar(h->evento_fd);
+                    } else {
+                        tocar_rodada(*h);
+                    }
+                }
+            }
+            if (hospedadas == 0) break;
+
+            int prontos = ::epoll_wait(epoll_fd, eventos.data(), static_cast<int>(eventos.size()), -1);
+            for (int e = 0; e < prontos; ++e) {
+                auto* h = static_cast<PartidaHospedada*>(eventos[e].data.ptr);
+                uint64_t contador;
+                [[maybe_unused]] ssize_t n = ::read(h->evento_fd, &contador, sizeof(contador));
+
+                if (!h->partida.terminou()) {
+                    h->partida.despachar_jogadores();
+                    h->partida.resolver_rodada();
+                }
+                if (!h->partida.terminou()) {
+                    tocar_rodada(*h);
+                    continue;
+                }
+
+                BlocoEmAndamento* origem = h->origem;
+                origem->resultados.push_back(h->partida.get_resultado());
+                ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, h->evento_fd, nullptr);
+                ::close(h->evento_fd);
+                delete h;
+                --hospedadas;
+                if (--origem->restantes == 0) {
+                    (*origem->bloco.entrega)(std::move(origem->resultados));
+                }
+            }
+
+            while (!blocos.empty() && blocos.front().restantes == 0) {
+                blocos.pop_front();
+            }
+        }
+        ::close(epoll_fd);
+    }
+
+    ModoEspera modo;
+    size_t partidas_por_worker;
+    std::unique_ptr<Maestro> maestro;
+    std::vector<std::thread> workers;
+    std::deque<Bloco> fila;
+    std::mutex fila_mutex;
+    std::condition_variable fila_cv;
+    bool ativo = true;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <vector>
+#include <string>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*
+ * Protocolo binário entre o coordenador e os jogadores externos (bots).
+ *
+ * Toda mensagem tem 16 bytes fixos, na ordem de bytes da máquina (o socket é
+ * Unix, então os dois lados sempre estão no mesmo host). Um processo bot pode
+ * hospedar vários jogadores numa única conexão; por isso as mensagens são
+ * acumuladas e enviadas em lote, com uma única escrita por conexão.
+ */
+enum class TipoMensagem : uint8_t {
+    Registro = 1,       // bot -> coordenador: valor = quantos jogadores o processo hospeda
+    BoasVindas = 2,     // coordenador -> bot: jogador = id atribuído (uma por jogador)
+    MusicaParou = 3,    // coordenador -> bot: jogador, rodada
+    PedidoCadeira = 4,  // bot -> coordenador: jogador, rodada
+    Resposta = 5,       // coordenador -> bot: valor = 1 se sentou
+    Eliminado = 6,      // coordenador -> bot: jogador
+    FimDeJogo = 7,      // coordenador -> bot: valor = vencedor
+};
+
+struct Mensagem {
+    uint8_t tipo;
+    uint8_t reservado[3];
+    uint32_t jogador;
+    uint32_t rodada;
+    uint32_t valor;
+};
+static_assert(sizeof(Mensagem) == 16, "o protocolo assume mensagens de 16 bytes");
+
+inline Mensagem criar_mensagem(TipoMensagem tipo, uint32_t jogador, uint32_t rodada = 0, uint32_t valor = 0) {
+    Mensagem m{};
+    m.tipo = static_cast<uint8_t>(tipo);
+    m.jogador = jogador;
+    m.rodada = rodada;
+    m.valor = valor;
+    return m;
+}
+
+// Ponta de uma conexão: acumula mensagens para envio em lote e remonta as
+// mensagens recebidas a partir de leituras parciais.
+class CanalMensagens {
+public:
+    explicit CanalMensagens(int fd = -1) : fd(fd) {}
+
+    void enfileirar(const Mensagem& m) {
+        enfileirar_bytes(&m, sizeof(Mensagem));
+    }
+
+    void enfileirar_bytes(const void* dados, size_t tamanho) {
+        const auto* bytes = static_cast<const char*>(dados);
+        saida.insert(saida.end(), bytes, bytes + tamanho);
+    }
+
+    bool tem_pendentes() const { return enviados < saida.size(); }
+
+    // Escreve o lote acumulado. Em sockets não bloqueantes pode sobrar parte
+    // do lote; retorna false apenas em erro real da conexão.
+    bool descarregar() {
+        while (enviados < saida.size()) {
+            ssize_t n = ::send(fd, saida.data() + enviados, saida.size() - enviados, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+                return false;
+            }
+            enviados += static_cast<size_t>(n);
+        }
+        saida.clear();
+        enviados = 0;
+        return true;
+    }
+
+    // Lê o que estiver disponível e anexa as mensagens completas em `recebidas`.
+    // Retorna false se a conexão foi fechada ou falhou.
+    bool receber(std::vector<Mensagem>& recebidas) {
+        if (!receber_bytes()) return false;
+        size_t completas = entrada.size() / sizeof(Mensagem);
+        for (size_t i = 0; i < completas; ++i) {
+            Mensagem m;
+            std::memcpy(&m, entrada.data() + i * sizeof(Mensagem), sizeof(Mensagem));
+            recebidas.push_back(m);
+        }
+        entrada.erase(entrada.begin(), entrada.begin() + completas * sizeof(Mensagem));
+        return true;
+    }
+
+    // Anexa ao buffer de entrada o que estiver disponível no socket.
+    bool receber_bytes() {
+        char buffer[65536];
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n < 0) {
+            return errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (n == 0) return false;
+        entrada.insert(entrada.end(), buffer, buffer + n);
+        return true;
+    }
+
+    std::vector<char>& get_entrada() { return entrada; }
+    void consumir(size_t tamanho) { entrada.erase(entrada.begin(), entrada.begin() + tamanho); }
+
+    int get_fd() const { return fd; }
+
+private:
+    int fd;
+    std::vector<char> saida;
+    size_t enviados = 0;
+    std::vector<char> entrada;
+};
+
+inline sockaddr_un endereco_unix(const std::string& caminho) {
+    sockaddr_un endereco{};
+    endereco.sun_family = AF_UNIX;
+    std::strncpy(endereco.sun_path, caminho.c_str(), sizeof(endereco.sun_path) - 1);
+    return endereco;
+}
+
+/*
+ * Protocolo do serviço de jogos.
+ *
+ * O cliente envia quadros `LoteJogos` com N especificações `EspecJogo` de 32
+ * bytes; o serviço responde com quadros `LoteResultados` contendo os
+ * `ResultadoCompacto` de 16 bytes que ficaram prontos desde o último envio,
+ * em qualquer ordem (o campo `id` identifica o pedido).
+ */
+enum class TipoQuadro : uint32_t {
+    LoteJogos = 1,
+    LoteResultados = 2,
+};
+
+struct CabecalhoQuadro {
+    uint32_t tipo;
+    uint32_t quantidade;
+};
+static_assert(sizeof(CabecalhoQuadro) == 8, "cabeçalho de quadro com 8 bytes");
+
+constexpr uint32_t MAX_ITENS_QUADRO = 1u << 20;
+constexpr uint32_t MAX_JOGADORES_PARTIDA = 1u << 16;  // por especificação recebida do cliente
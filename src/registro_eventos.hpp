@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "armazem.hpp"
+
+/*
+ * Log compacto de eventos por assento: em cada rodada, cada tentativa de
+ * sentar vira (jogador, cadeira, instante). O arquivo é uma sequência de
+ * blocos, um por rodada, cada um prefixado pelo próprio tamanho:
+ *
+ *   varint tamanho do corpo
+ *   corpo:  zigzag(partida - partida anterior), varint rodada,
+ *           zigzag(base - base anterior), varint número de eventos, e por evento
+ *           zigzag(jogador - jogador anterior), varint cadeira (1 em
+ *           diante; 0 = sem cadeira), zigzag(instante - instante anterior)
+ *
+ * Instantes em ns; a base é o instante em que a música parou e o primeiro
+ * evento da rodada é codificado contra ela. O leitor decodifica rodada a
+ * rodada com um buffer de tamanho fixo, sem carregar o arquivo inteiro.
+ */
+struct EventoAssento {
+    int jogador;
+    int cadeira;  // a partir de 1; 0 = ficou sem cadeira
+    int64_t instante_ns;
+};
+
+struct RodadaEventos {
+    uint64_t partida = 0;
+    uint32_t rodada = 0;
+    int64_t base_ns = 0;
+    std::vector<EventoAssento> eventos;
+};
+
+namespace registro {
+constexpr char MAGICA[8] = {'C', 'A', 'D', 'E', 'V', 'T', '0', '1'};
+
+// Onde um log existente termina e o estado dos deltas nesse ponto, para
+// acrescentar rodadas a ele. `bytes == 0` cria um log novo.
+struct Continuacao {
+    uint64_t bytes = 0;
+    uint64_t partida = 0;
+    int64_t base_ns = 0;
+};
+}  // namespace registro
+
+// O motor acumula eventos em lotes na memória; uma thread de fundo codifica e
+// grava cada lote. Com lotes demais na fila, o motor espera (contrapressão).
+// Os métodos de produção não são thread-safe: um produtor por codificador.
+class CodificadorEventos {
+public:
+    explicit CodificadorEventos(const std::string& caminho, const registro::Continuacao& continuacao = {},
+                                size_t eventos_por_lote = 1 << 16, size_t lotes_na_fila = 4)
+        : eventos_por_lote(eventos_por_lote),
+          lotes_na_fila(lotes_na_fila),
+          partida_anterior(continuacao.partida),
+          base_anterior(continuacao.base_ns) {
+        arquivo = std::fopen(caminho.c_str(), continuacao.bytes == 0 ? "wb" : "r+b");
+        if (!arquivo) throw std::runtime_error("log de eventos " + caminho + ": " + std::strerror(errno));
+        if (continuacao.bytes == 0) {
+            std::fwrite(registro::MAGICA, 1, sizeof(registro::MAGICA), arquivo);
+        } else {
+            // Descarta um bloco final rasgado e continua depois da última rodada inteira.
+            if (::ftruncate(::fileno(arquivo), static_cast<off_t>(continuacao.bytes)) < 0 ||
+                std::fseek(arquivo, 0, SEEK_END) < 0) {
+                std::string erro = std::strerror(errno);
+                std::fclose(arquivo);
+                throw std::runtime_error("log de eventos " + caminho + ": " + erro);
+            }
+            bytes_gravados = continuacao.bytes;
+        }
+        std::setvbuf(arquivo, nullptr, _IOFBF, 1 << 20);
+        atual.eventos.reserve(eventos_por_lote);
+        codificador = std::thread(&CodificadorEventos::codificar, this);
+    }
+
+    ~CodificadorEventos() {
+        entregar_lote();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ativo = false;
+        }
+        fila_cv.notify_one();
+        codificador.join();
+        std::fclose(arquivo);
+    }
+
+    CodificadorEventos(const CodificadorEventos&) = delete;
+    CodificadorEventos& operator=(const CodificadorEventos&) = delete;
+
+    void abrir_rodada(uint64_t partida, uint32_t rodada, int64_t base_ns) {
+        if (atual.eventos.size() >= eventos_por_lote) entregar_lote();
+        atual.rodadas.push_back(Rodada{partida, rodada, base_ns, atual.eventos.size()});
+    }
+
+    void registrar(int jogador, int cadeira, int64_t instante_ns) {
+        atual.eventos.push_back(EventoAssento{jogador, cadeira, instante_ns});
+    }
+
+    uint64_t get_bytes_gravados() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return bytes_gravados;
+    }
+
+private:
+    struct Rodada {
+        uint64_t partida;
+        uint32_t rodada;
+        int64_t base_ns;
+        size_t primeiro_evento;
+    };
+
+    struct Lote {
+        std::vector<Rodada> rodadas;
+        std::vector<EventoAssento> eventos;
+    };
+
+    void entregar_lote() {
+        if (atual.rodadas.empty()) return;
+        std::unique_lock<std::mutex> lock(mutex);
+        espaco_cv.wait(lock, [&] { return fila.size() < lotes_na_fila; });
+        fila.push_back(std::move(atual));
+        lock.unlock();
+        fila_cv.notify_one();
+
+        atual = Lote{};
+        atual.eventos.reserve(eventos_por_lote);
+    }
+
+    void codificar() {
+        std::vector<uint8_t> corpo, saida;
+        while (true) {
+            Lote lote;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                fila_cv.wait(lock, [&] { return !fila.empty() || !ativo; });
+                if (fila.empty()) return;
+                lote = std::move(fila.front());
+                fila.pop_front();
+            }
+            espaco_cv.notify_one();
+
+            saida.clear();
+            for (size_t r = 0; r < lote.rodadas.size(); ++r) {
+                const Rodada& rodada = lote.rodadas[r];
+                size_t fim = r + 1 < lote.rodadas.size() ? lote.rodadas[r + 1].primeiro_evento : lote.eventos.size();
+                corpo.clear();
+                armazem::escrever_varint(corpo, armazem::zigzag(static_cast<int64_t>(rodada.partida - partida_anterior)));
+                armazem::escrever_varint(corpo, rodada.rodada);
+                armazem::escrever_varint(corpo, armazem::zigzag(rodada.base_ns - base_anterior));
+                armazem::escrever_varint(corpo, fim - rodada.primeiro_evento);
+                partida_anterior = rodada.partida;
+                base_anterior = rodada.base_ns;
+
+                int jogador_anterior = 0;
+                int64_t instante_anterior = rodada.base_ns;
+                for (size_t e = rodada.primeiro_evento; e < fim; ++e) {
+                    const EventoAssento& ev = lote.eventos[e];
+                    armazem::escrever_varint(corpo, armazem::zigzag(ev.jogador - jogador_anterior));
+                    armazem::escrever_varint(corpo, static_cast<uint64_t>(ev.cadeira));
+                    armazem::escrever_varint(corpo, armazem::zigzag(ev.instante_ns - instante_anterior));
+                    jogador_anterior = ev.jogador;
+                    instante_anterior = ev.instante_ns;
+                }
+                armazem::escrever_varint(saida, corpo.size());
+                saida.insert(saida.end(), corpo.begin(), corpo.end());
+            }
+            std::fwrite(saida.data(), 1, saida.size(), arquivo);
+            std::lock_guard<std::mutex> lock(mutex);
+            bytes_gravados += saida.size();
+        }
+    }
+
+    size_t eventos_por_lote;
+    size_t lotes_na_fila;
+    uint64_t partida_anterior;  // estado dos deltas, só da thread codificadora
+    int64_t base_anterior;
+    std::FILE* arquivo = nullptr;
+    Lote atual;
+
+    mutable std::mutex mutex;
+    std::condition_variable fila_cv;
+    std::condition_variable espaco_cv;
+    std::deque<Lote> fila;
+    bool ativo = true;
+    uint64_t bytes_gravados = sizeof(registro::MAGICA);
+    std::thread codificador;
+};
+
+// Lê o log rodada a rodada. Só o bloco da rodada atual precisa caber no buffer.
+class DecodificadorEventos {
+public:
+    explicit DecodificadorEventos(const std::string& caminho) {
+        arquivo = std::fopen(caminho.c_str(), "rb");
+        if (!arquivo) throw std::runtime_error("log de eventos " + caminho + ": " + std::strerror(errno));
+        char magica[sizeof(registro::MAGICA)];
+        if (std::fread(magica, 1, sizeof(magica), arquivo) != sizeof(magica) ||
+            std::memcmp(magica, registro::MAGICA, sizeof(magica)) != 0) {
+            std::fclose(arquivo);
+            throw std::runtime_error("log de eventos " + caminho + ": formato desconhecido");
+        }
+        struct stat info;
+        if (::fstat(::fileno(arquivo), &info) == 0 && static_cast<uint64_t>(info.st_size) > sizeof(magica)) {
+            restante_arquivo = static_cast<uint64_t>(info.st_size) - sizeof(magica);
+        }
+        buffer.resize(1 << 16);
+    }
+
+    ~DecodificadorEventos() { std::fclose(arquivo); }
+
+    DecodificadorEventos(const DecodificadorEventos&) = delete;
+    DecodificadorEventos& operator=(const DecodificadorEventos&) = delete;
+
+    // Preenche `saida` com a próxima rodada; false no fim do arquivo (ou num
+    // bloco final truncado).
+    bool proxima(RodadaEventos& saida) {
+        const bool completo = garantir(10);
+        if (!completo && inicio == fim) return false;
+        // Prefixo de tamanho cortado no fim do arquivo: bloco final truncado.
+        const uint8_t* prefixo = buffer.data() + inicio;
+        const uint8_t* disponivel = buffer.data() + fim;
+        if (!completo && std::none_of(prefixo, disponivel, [](uint8_t b) { return b < 0x80; })) return false;
+        uint64_t tamanho;
+        const uint8_t* p = armazem::ler_varint(prefixo, disponivel, tamanho);
+        size_t cabecalho = static_cast<size_t>(p - prefixo);
+        if (tamanho > restante_arquivo + (fim - inicio - cabecalho)) return false;
+        if (!garantir(cabecalho + tamanho)) return false;
+        p = buffer.data() + inicio + cabecalho;
+        const uint8_t* fim_corpo = p + tamanho;
+
+        uint64_t valor, quantidade;
+        p = armazem::ler_varint(p, fim_corpo, valor);
+        partida += static_cast<uint64_t>(armazem::desfazer_zigzag(valor));
+        p = armazem::ler_varint(p, fim_corpo, valor);
+        saida.rodada = static_cast<uint32_t>(valor);
+        p = armazem::ler_varint(p, fim_corpo, valor);
+        base += armazem::desfazer_zigzag(valor);
+        p = armazem::ler_varint(p, fim_corpo, quantidade);
+        saida.partida = partida;
+        saida.base_ns = base;
+
+        // Cada evento ocupa ao menos três bytes (um por varint): uma contagem
+        // maior que o corpo é corrupção, não um pedido de memória.
+        if (quantidade > static_cast<uint64_t>(fim_corpo - p) / 3) throw std::runtime_error("log de eventos corrompido");
+        saida.eventos.resize(quantidade);
+        int jogador = 0;
+        int64_t instante = base;
+        for (EventoAssento& ev : saida.eventos) {
+            p = armazem::ler_varint(p, fim_corpo, valor);
+            jogador += static_cast<int>(armazem::desfazer_zigzag(valor));
+            p = armazem::ler_varint(p, fim_corpo, valor);
+            if (valor > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+                throw std::runtime_error("log de eventos corrompido");
+            }
+            ev.cadeira = static_cast<int>(valor);
+            p = armazem::ler_varint(p, fim_corpo, valor);
+            instante += armazem::desfazer_zigzag(valor);
+            ev.jogador = jogador;
+            ev.instante_ns = instante;
+        }
+        if (p != fim_corpo) throw std::runtime_error("log de eventos corrompido");
+        inicio += cabecalho + tamanho;
+        consumidos += cabecalho + tamanho;
+        return true;
+    }
+
+    // Fim da última rodada lida e o estado dos deltas nesse ponto.
+    registro::Continuacao continuacao() const { return {consumidos, partida, base}; }
+
+private:
+    // Garante `n` bytes a partir de `inicio`, movendo o resto para o começo
+    // do buffer e lendo mais do arquivo. False se o arquivo acabou antes.
+    bool garantir(size_t n) {
+        if (fim - inicio >= n) return true;
+        std::memmove(buffer.data(), buffer.data() + inicio, fim - inicio);
+        fim -= inicio;
+        inicio = 0;
+        if (buffer.size() < n) buffer.resize(n);
+        size_t lidos = std::fread(buffer.data() + fim, 1, buffer.size() - fim, arquivo);
+        fim += lidos;
+        restante_arquivo -= std::min<uint64_t>(restante_arquivo, lidos);
+        return fim - inicio >= n;
+    }
+
+    std::FILE* arquivo = nullptr;
+    std::vector<uint8_t> buffer;
+    size_t inicio = 0;
+    size_t fim = 0;
+    uint64_t restante_arquivo = 0;  // bytes ainda não lidos: limita o tamanho de bloco aceito
+    uint64_t consumidos = sizeof(registro::MAGICA);
+    uint64_t partida = 0;
+    int64_t base = 0;
+};
+
+// Lê um log existente até a última rodada inteira, para acrescentar a ele ao
+// retomar uma simulação. Um log que ainda não existe (ou vazio) começa do zero.
+inline registro::Continuacao continuar_log_eventos(const std::string& caminho) {
+    struct stat info;
+    if (::stat(caminho.c_str(), &info) < 0 ? errno == ENOENT : info.st_size == 0) return {};
+    DecodificadorEventos leitor(caminho);
+    RodadaEventos rodada;
+    while (leitor.proxima(rodada)) {
+    }
+    return leitor.continuacao();
+}
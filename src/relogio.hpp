@@ -0,0 +1,183 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define CADEIRAS_TEM_TSC 1
+#endif
+
+/*
+ * Relógio para a instrumentação dos caminhos quentes (instantes de tentativa,
+ * de assento, fases da rodada). Com TSC invariante, `now()` é um `rdtsc` e
+ * uma multiplicação, bem mais barato que `steady_clock::now()` pelo vDSO.
+ *
+ * Na primeira chamada o relógio se calibra:
+ * - confere na CPUID que o TSC é invariante (não muda com a frequência nem
+ *   para em estados de economia);
+ * - mede a frequência contra `steady_clock` ao longo de ~20 ms;
+ * - em cada CPU permitida ao processo, compara o TSC convertido com o
+ *   `steady_clock` para pegar núcleos com TSC dessincronizado.
+ * Se qualquer passo falhar, ou com CADEIRAS_RELOGIO=steady no ambiente,
+ * `now()` usa `steady_clock` e o resto do código não percebe a diferença.
+ *
+ * É um relógio do <chrono> (`is_steady`), mas só para medir intervalos:
+ * prazos de espera em variáveis de condição continuam em `steady_clock`.
+ * Quem não pode pagar a calibração no meio do caminho quente chama
+ * `calibrar()` antes.
+ */
+class RelogioRapido {
+public:
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<RelogioRapido>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        const Calibracao& c = calibracao();
+#ifdef CADEIRAS_TEM_TSC
+        if (c.usa_tsc) {
+            // Com sinal: um núcleo cujo TSC está um pouco atrás (dentro da
+            // tolerância da calibração) pode ler antes de `base_ticks`.
+            int64_t delta = static_cast<int64_t>(__rdtsc() - c.base_ticks);
+            return time_point(duration(c.base_ns + static_cast<int64_t>(
+                (static_cast<__int128>(delta) * static_cast<__int128>(c.multiplicador)) >> DESLOCAMENTO)));
+        }
+#endif
+        return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now().time_since_epoch()));
+    }
+
+    static void calibrar() { calibracao(); }
+    static bool usa_tsc() { return calibracao().usa_tsc; }
+    static double get_ghz() { return calibracao().ghz; }
+    // Por que o relógio usa o TSC ou por que caiu para `steady_clock`.
+    static const std::string& get_descricao() { return calibracao().descricao; }
+
+private:
+    static constexpr int DESLOCAMENTO = 32;  // ns = ticks * multiplicador >> 32
+
+    struct Calibracao {
+        bool usa_tsc = false;
+        uint64_t base_ticks = 0;
+        int64_t base_ns = 0;
+        uint64_t multiplicador = 0;
+        double ghz = 0;
+        std::string descricao;
+    };
+
+    struct Amostra {
+        uint64_t ticks;
+        int64_t ns;
+        uint64_t janela;  // ticks entre os dois rdtsc que cercam a leitura do steady_clock
+    };
+
+    static const Calibracao& calibracao() {
+        static const Calibracao c = medir();
+        return c;
+    }
+
+    static int64_t steady_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+#ifdef CADEIRAS_TEM_TSC
+    // Leitura pareada TSC/steady_clock; das tentativas, fica a de menor janela.
+    static Amostra amostrar() {
+        Amostra melhor{0, 0, ~0ull};
+        for (int i = 0; i < 16; ++i) {
+            uint64_t antes = __rdtsc();
+            int64_t ns = steady_ns();
+            uint64_t depois = __rdtsc();
+            if (depois - antes < melhor.janela) melhor = Amostra{antes + (depois - antes) / 2, ns, depois - antes};
+        }
+        return melhor;
+    }
+
+    static bool tsc_invariante() {
+        unsigned a, b, c, d;
+        if (!__get_cpuid(0x80000000, &a, &b, &c, &d) || a < 0x80000007) return false;
+        __get_cpuid(0x80000007, &a, &b, &c, &d);
+        return (d >> 8) & 1;
+    }
+
+    // Erro, em ns, entre o TSC convertido e o steady_clock na CPU `cpu`.
+    static bool erro_na_cpu(int cpu, const Calibracao& c, int64_t& erro) {
+        bool ok = false;
+        std::thread([&] {
+            cpu_set_t conjunto;
+            CPU_ZERO(&conjunto);
+            CPU_SET(cpu, &conjunto);
+            if (::sched_setaffinity(0, sizeof(conjunto), &conjunto) != 0) return;
+            Amostra a = amostrar();
+            int64_t previsto = c.base_ns + static_cast<int64_t>(
+                (static_cast<unsigned __int128>(a.ticks - c.base_ticks) * c.multiplicador) >> DESLOCAMENTO);
+            erro = previsto - a.ns;
+            ok = true;
+        }).join();
+        return ok;
+    }
+#endif
+
+    static Calibracao medir() {
+        Calibracao c;
+        const char* escolha = std::getenv("CADEIRAS_RELOGIO");
+        if (escolha && std::strcmp(escolha, "steady") == 0) {
+            c.descricao = "steady_clock (CADEIRAS_RELOGIO=steady)";
+            return c;
+        }
+#ifdef CADEIRAS_TEM_TSC
+        if (!tsc_invariante()) {
+            c.descricao = "steady_clock (TSC não é invariante nesta CPU)";
+            return c;
+        }
+        Amostra inicio = amostrar();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        Amostra fim = amostrar();
+        if (fim.ns <= inicio.ns || fim.ticks <= inicio.ticks) {
+            c.descricao = "steady_clock (calibração do TSC falhou)";
+            return c;
+        }
+        double ns_por_tick = static_cast<double>(fim.ns - inicio.ns) / static_cast<double>(fim.ticks - inicio.ticks);
+        c.base_ticks = fim.ticks;
+        c.base_ns = fim.ns;
+        c.multiplicador = static_cast<uint64_t>(ns_por_tick * static_cast<double>(1ull << DESLOCAMENTO));
+        c.ghz = 1.0 / ns_por_tick;
+
+        // Tolerância: a incerteza das duas leituras pareadas mais 1 µs.
+        const int64_t tolerancia = static_cast<int64_t>((inicio.janela + fim.janela) * ns_por_tick) + 1000;
+        cpu_set_t permitidas;
+        int64_t pior = 0;
+        int cpus = 0;
+        if (::sched_getaffinity(0, sizeof(permitidas), &permitidas) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (!CPU_ISSET(cpu, &permitidas)) continue;
+                int64_t erro = 0;
+                if (!erro_na_cpu(cpu, c, erro)) continue;
+                ++cpus;
+                pior = std::max(pior, erro < 0 ? -erro : erro);
+            }
+        }
+        if (pior > tolerancia) {
+            c.descricao = "steady_clock (TSC diverge " + std::to_string(pior) + " ns entre núcleos)";
+            return c;
+        }
+        c.usa_tsc = true;
+        c.descricao = "TSC invariante a " + std::to_string(c.ghz).substr(0, 5) + " GHz, conferido em " +
+                      std::to_string(cpus) + " CPUs (maior erro " + std::to_string(pior) + " ns)";
+#else
+        c.descricao = "steady_clock (sem TSC nesta arquitetura)";
+#endif
+        return c;
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Seqlock para um valor pequeno e trivialmente copiável, com um escritor e
+ * qualquer número de leitores. O escritor nunca espera: incrementa a
+ * sequência (ímpar = escrita em andamento), grava e incrementa de novo. O
+ * leitor copia o valor e confere se a sequência não mudou no meio; se mudou,
+ * tenta de novo. Ler não escreve em nada compartilhado, então leitores não
+ * disputam linhas de cache entre si nem com o escritor além da leitura.
+ *
+ * Os dados ficam em palavras atômicas de 64 bits (acesso relaxado), sem
+ * corrida de dados formal. Sem ponteiros internos: funciona também em
+ * memória compartilhada entre processos, inclusive mapeada só para leitura
+ * do lado dos leitores. Memória zerada é um seqlock válido e vazio.
+ */
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable_v<T>, "o valor é copiado byte a byte");
+
+public:
+    // Só um escritor por vez; quem tem mais de um serializa por fora.
+    void escrever(const T& valor) {
+        uint64_t palavras[PALAVRAS] = {};
+        std::memcpy(palavras, &valor, sizeof(T));
+        uint64_t s = sequencia.load(std::memory_order_relaxed);
+        sequencia.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < PALAVRAS; ++i) dados[i].store(palavras[i], std::memory_order_relaxed);
+        sequencia.store(s + 2, std::memory_order_release);
+    }
+
+    // Uma tentativa; false se cruzou com uma escrita.
+    bool tentar_ler(T& saida) const {
+        uint64_t antes = sequencia.load(std::memory_order_acquire);
+        if (antes & 1) return false;
+        uint64_t palavras[PALAVRAS];
+        for (size_t i = 0; i < PALAVRAS; ++i) palavras[i] = dados[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequencia.load(std::memory_order_relaxed) != antes) return false;
+        std::memcpy(&saida, palavras, sizeof(T));
+        return true;
+    }
+
+    T ler() const {
+        T valor;
+        for (int tentativa = 0; !tentar_ler(valor); ++tentativa) {
+            if (tentativa >= 64) std::this_thread::yield();  // escritor descalendarizado no meio da escrita
+        }
+        return valor;
+    }
+
+    // Número de escritas publicadas até agora.
+    uint64_t get_versao() const { return sequencia.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t PALAVRAS = (sizeof(T) + 7) / 8;
+
+    std::atomic<uint64_t> sequencia{0};
+    std::atomic<uint64_t> dados[PALAVRAS] = {};
+};
+
+/*
+ * Mesma ideia para um cabeçalho fixo seguido de uma lista de tamanho
+ * variável, com capacidade definida na construção (por exemplo, os ocupantes
+ * das cadeiras de uma rodada). Os itens são atômicos sem lock; o leitor copia
+ * o cabeçalho e os `n` itens e valida a sequência como no `Seqlock`.
+ */
+template <typename Cabecalho, typename Item>
+class SeqlockLista {
+    static_assert(std::is_trivially_copyable_v<Cabecalho>, "o cabeçalho é copiado byte a byte");
+    static_assert(std::atomic<Item>::is_always_lock_free, "itens precisam de atômicos sem lock");
+
+public:
+    explicit SeqlockLista(size_t capacidade)
+        : capacidade(capacidade), itens(std::make_unique<std::atomic<Item>[]>(capacidade)) {}
+
+    size_t get_capacidade() const { return capacidade; }
+
+    // Só um escritor por vez; `n` é limitado à capacidade.
+    void escrever(const Cabecalho& cabecalho, const Item* lista, size_t n) {
+        n = std::min(n, capacidade);
+        uint64_t s = sequencia.load(std::memory_order_relaxed);
+        sequencia.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        fixo.escrever_dentro(cabecalho);
+        tamanho.store(n, std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) itens[i].store(lista[i], std::memory_order_relaxed);
+        sequencia.store(s + 2, std::memory_order_release);
+    }
+
+    bool tentar_ler(Cabecalho& cabecalho, std::vector<Item>& lista) const {
+        uint64_t antes = sequencia.load(std::memory_order_acquire);
+        if (antes & 1) return false;
+        Cabecalho c = fixo.ler_dentro();
+        size_t n = std::min<size_t>(tamanho.load(std::memory_order_relaxed), capacidade);
+        lista.resize(n);
+        for (size_t i = 0; i < n; ++i) lista[i] = itens[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequencia.load(std::memory_order_relaxed) != antes) return false;
+        cabecalho = c;
+        return true;
+    }
+
+    void ler(Cabecalho& cabecalho, std::vector<Item>& lista) const {
+        for (int tentativa = 0; !tentar_ler(cabecalho, lista); ++tentativa) {
+            if (tentativa >= 64) std::this_thread::yield();
+        }
+    }
+
+    uint64_t get_versao() const { return sequencia.load(std::memory_order_acquire) / 2; }
+
+private:
+    // Palavras do cabeçalho, acessadas dentro da seção protegida pela sequência de fora.
+    struct Palavras {
+        static constexpr size_t N = (sizeof(Cabecalho) + 7) / 8;
+        std::atomic<uint64_t> dados[N] = {};
+
+        void escrever_dentro(const Cabecalho& valor) {
+            uint64_t palavras[N] = {};
+            std::memcpy(palavras, &valor, sizeof(Cabecalho));
+            for (size_t i = 0; i < N; ++i) dados[i].store(palavras[i], std::memory_order_relaxed);
+        }
+        Cabecalho ler_dentro() const {
+            uint64_t palavras[N];
+            for (size_t i = 0; i < N; ++i) palavras[i] = dados[i].load(std::memory_order_relaxed);
+            Cabecalho valor;
+            std::memcpy(&valor, palavras, sizeof(Cabecalho));
+            return valor;
+        }
+    };
+
+    size_t capacidade;
+    std::atomic<uint64_t> sequencia{0};
+    Palavras fixo;
+    std::atomic<size_t> tamanho{0};
+    std::unique_ptr<std::atomic<Item>[]> itens;
+};
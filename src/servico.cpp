@@ -0,0 +1,154 @@
+// Serviço de jogos: `ServicoJogos servidor` mantém o pool aberto e atende
+// lotes de partidas; `ServicoJogos cliente` é o gerador de carga que submete
+// partidas em lotes e mede a vazão de ponta a ponta.
+#include <csignal>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "opcoes.hpp"
+#include "partida.hpp"
+#include "protocolo.hpp"
+#include "servico.hpp"
+
+namespace {
+
+ServicoJogos* servico_ativo = nullptr;
+
+void tratar_sinal(int) {
+    if (servico_ativo) servico_ativo->parar();
+}
+
+bool escrever_tudo(int fd, const char* dados, size_t tamanho) {
+    while (tamanho > 0) {
+        ssize_t n = ::send(fd, dados, tamanho, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        dados += n;
+        tamanho -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int executar_servidor(const Opcoes& opcoes) {
+    ServicoJogos servico(opcoes.texto("socket", "/tmp/servico_cadeiras.sock"),
+                         static_cast<int>(opcoes.inteiro("workers", 0)),
+                         static_cast<size_t>(opcoes.inteiro("bloco", 64)),
+                         opcoes.tem("eventos") ? ModoEspera::EventFd : ModoEspera::CondicaoMusica,
+                         static_cast<size_t>(opcoes.inteiro("partidas-por-worker", 256)));
+    if (opcoes.tem("cache")) {
+        servico.usar_cache(std::make_unique<CacheResultados>(opcoes.texto("cache"),
+                                                             static_cast<size_t>(opcoes.inteiro("cache-mb", 64))));
+    }
+    servico_ativo = &servico;
+    std::signal(SIGINT, tratar_sinal);
+    std::signal(SIGTERM, tratar_sinal);
+    servico.executar();
+    std::cout << "Serviço encerrado após " << servico.get_partidas_recebidas() << " partidas.\n";
+    if (const CacheResultados* cache = servico.get_cache()) {
+        std::cout << "Cache: " << cache->get_acertos() << " acertos, " << cache->get_faltas() << " faltas, "
+                  << cache->get_substituicoes() << " substituições (" << cache->get_capacidade() << " entradas)\n";
+    }
+    return 0;
+}
+
+int executar_cliente(const Opcoes& opcoes) {
+    std::string caminho = opcoes.texto("socket", "/tmp/servico_cadeiras.sock");
+    uint32_t total = static_cast<uint32_t>(opcoes.inteiro("jogos", 100000));
+    uint32_t tamanho_lote = static_cast<uint32_t>(opcoes.inteiro("lote", 1024));
+
+    EspecJogo modelo;
+    modelo.num_jogadores = static_cast<uint32_t>(opcoes.inteiro("jogadores", 8));
+    modelo.musica_us = static_cast<uint32_t>(opcoes.inteiro("musica-us", 0));
+    modelo.politica = static_cast<uint8_t>(opcoes.texto("politica") == "persistente"
+                                               ? PoliticaReacao::Persistente : PoliticaReacao::Aleatoria);
+    ler_cronograma(opcoes.texto("cronograma", "1"), modelo);
+    uint64_t semente = static_cast<uint64_t>(opcoes.inteiro("semente", 1));
+    if (modelo.num_jogadores > MAX_JOGADORES_PARTIDA) {
+        std::cerr << "--jogadores acima do limite do serviço (" << MAX_JOGADORES_PARTIDA << ")\n";
+        return 1;
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un endereco = endereco_unix(caminho);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0) {
+        std::cerr << "Não foi possível conectar em " << caminho << ": " << std::strerror(errno) << "\n";
+        return 1;
+    }
+
+    auto inicio = std::chrono::steady_clock::now();
+
+    std::thread envio([&] {
+        std::vector<char> quadro;
+        for (uint32_t enviados = 0; enviados < total;) {
+            uint32_t n = std::min(tamanho_lote, total - enviados);
+            CabecalhoQuadro cabecalho{static_cast<uint32_t>(TipoQuadro::LoteJogos), n};
+            quadro.resize(sizeof(cabecalho) + n * sizeof(EspecJogo));
+            std::memcpy(quadro.data(), &cabecalho, sizeof(cabecalho));
+            auto* specs = reinterpret_cast<EspecJogo*>(quadro.data() + sizeof(cabecalho));
+            for (uint32_t i = 0; i < n; ++i) {
+                specs[i] = modelo;
+                specs[i].id = enviados + i;
+                specs[i].semente = semente + enviados + i;
+            }
+            if (!escrever_tudo(fd, quadro.data(), quadro.size())) return;
+            enviados += n;
+        }
+    });
+
+    CanalMensagens canal(fd);
+    uint32_t recebidos = 0;
+    uint64_t quadros = 0;
+    uint32_t assinatura = 0;
+    std::vector<uint32_t> vitorias(modelo.num_jogadores + 1, 0);
+    while (recebidos < total) {
+        if (!canal.receber_bytes()) break;
+        std::vector<char>& entrada = canal.get_entrada();
+        size_t lido = 0;
+        while (entrada.size() - lido >= sizeof(CabecalhoQuadro)) {
+            CabecalhoQuadro cabecalho;
+            std::memcpy(&cabecalho, entrada.data() + lido, sizeof(cabecalho));
+            size_t tamanho = sizeof(cabecalho) + cabecalho.quantidade * sizeof(ResultadoCompacto);
+            if (entrada.size() - lido < tamanho) break;
+            for (uint32_t i = 0; i < cabecalho.quantidade; ++i) {
+                ResultadoCompacto r;
+                std::memcpy(&r, entrada.data() + lido + sizeof(cabecalho) + i * sizeof(r), sizeof(r));
+                assinatura ^= r.assinatura;
+                if (r.vencedor < vitorias.size()) ++vitorias[r.vencedor];
+            }
+            recebidos += cabecalho.quantidade;
+            ++quadros;
+            lido += tamanho;
+        }
+        canal.consumir(lido);
+    }
+    envio.join();
+    ::close(fd);
+
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    std::cout << recebidos << " partidas em " << segundos << " s ("
+              << static_cast<uint64_t>(recebidos / segundos) << " partidas/s, "
+              << quadros << " quadros de resposta)\n";
+    std::cout << "Assinatura combinada: " << std::hex << assinatura << std::dec << "\n";
+    for (size_t id = 1; id < vitorias.size(); ++id) {
+        std::cout << "  P" << id << ": " << vitorias[id] << " vitórias\n";
+    }
+    return recebidos == total ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Opcoes opcoes(argc, argv);
+    if (opcoes.modo() == "cliente") {
+        return executar_cliente(opcoes);
+    }
+    return executar_servidor(opcoes);
+}
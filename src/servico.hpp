@@ -0,0 +1,299 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "cache_resultados.hpp"
+#include "partida.hpp"
+#include "pool_partidas.hpp"
+#include "protocolo.hpp"
+
+/*
+ * Serviço de longa duração que recebe lotes de especificações de partidas por
+ * um socket Unix, executa-as no PoolPartidas e devolve resultados compactos.
+ *
+ * Uma única thread de E/S cuida de todas as conexões com `epoll`. Os workers
+ * não escrevem em sockets: acumulam resultados na saída da conexão e acordam a
+ * thread de E/S por um `eventfd` apenas quando a saída estava vazia, de modo
+ * que vários blocos concluídos viram um único quadro `LoteResultados`.
+ *
+ * Com um CacheResultados, especificações já jogadas são respondidas na hora
+ * pela thread de E/S e só as novas vão para o pool.
+ */
+class ServicoJogos {
+public:
+    ServicoJogos(std::string caminho, int num_workers, size_t tamanho_bloco = 64,
+                 ModoEspera modo = ModoEspera::CondicaoMusica, size_t partidas_por_worker = 256)
+        : caminho(std::move(caminho)), tamanho_bloco(tamanho_bloco),
+          pool(std::make_unique<PoolPartidas>(num_workers, modo, partidas_por_worker)) {
+        escuta_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (escuta_fd < 0) throw std::runtime_error("socket: " + std::string(std::strerror(errno)));
+        ::unlink(this->caminho.c_str());
+        sockaddr_un endereco = endereco_unix(this->caminho);
+        if (::bind(escuta_fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 ||
+            ::listen(escuta_fd, 128) < 0) {
+            throw std::runtime_error("bind/listen em " + this->caminho + ": " + std::strerror(errno));
+        }
+        epoll_fd = ::epoll_create1(EPOLL_CLOEXEC);
+        aviso_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        registrar(escuta_fd, EPOLLIN);
+        registrar(aviso_fd, EPOLLIN);
+    }
+
+    ~ServicoJogos() {
+        pool.reset();  // os workers param antes de os descritores serem fechados
+        for (auto& [fd, _] : conexoes) ::close(fd);
+        ::close(aviso_fd);
+        ::close(epoll_fd);
+        ::close(escuta_fd);
+        ::unlink(caminho.c_str());
+    }
+
+    // Pode ser chamado de um tratador de sinal: só usa um atômico e `write`.
+    void parar() {
+        rodando.store(false);
+        uint64_t um = 1;
+        [[maybe_unused]] ssize_t n = ::write(aviso_fd, &um, sizeof(um));
+    }
+
+    void executar() {
+        std::vector<epoll_event> eventos(256);
+        while (rodando.load()) {
+            int prontos = ::epoll_wait(epoll_fd, eventos.data(), static_cast<int>(eventos.size()), -1);
+            if (prontos < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("epoll_wait: " + std::string(std::strerror(errno)));
+            }
+            for (int e = 0; e < prontos; ++e) {
+                int fd = eventos[e].data.fd;
+                if (fd == escuta_fd) {
+                    aceitar();
+                } else if (fd == aviso_fd) {
+                    uint64_t contador;
+                    [[maybe_unused]] ssize_t n = ::read(aviso_fd, &contador, sizeof(contador));
+                    enviar_resultados();
+                } else {
+                    atender(fd, eventos[e].events);
+                }
+            }
+        }
+    }
+
+    uint64_t get_partidas_recebidas() const { return partidas_recebidas; }
+
+    // Deve ser chamado antes de `executar()`.
+    void usar_cache(std::unique_ptr<CacheResultados> novo) { cache = std::move(novo); }
+    const CacheResultados* get_cache() const { return cache.get(); }
+
+private:
+    struct SaidaConexao {
+        int fd;
+        std::mutex mutex;
+        std::vector<ResultadoCompacto> prontos;
+    };
+
+    struct Conexao {
+        CanalMensagens canal;
+        std::shared_ptr<SaidaConexao> saida;
+        bool aguardando_escrita = false;
+    };
+
+    void registrar(int fd, uint32_t eventos) {
+        epoll_event ev{};
+        ev.events = eventos;
+        ev.data.fd = fd;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+    }
+
+    void aceitar() {
+        while (true) {
+            int fd = ::accept4(escuta_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;
+            auto saida = std::make_shared<SaidaConexao>();
+            saida->fd = fd;
+            conexoes.emplace(fd, Conexao{CanalMensagens(fd), saida});
+            registrar(fd, EPOLLIN);
+        }
+    }
+
+    void fechar(int fd) {
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        conexoes.erase(fd);
+        ::close(fd);
+    }
+
+    void atender(int fd, uint32_t eventos) {
+        auto it = conexoes.find(fd);
+        if (it == conexoes.end()) return;
+        Conexao& conexao = it->second;
+
+        if (eventos & EPOLLOUT) {
+            if (!conexao.canal.descarregar()) {
+                fechar(fd);
+                return;
+            }
+            atualizar_interesse(fd, conexao);
+        }
+        if (eventos & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+            if (!conexao.canal.receber_bytes() || !processar_quadros(conexao)) {
+                fechar(fd);
+            }
+        }
+    }
+
+    // Junta todas as especificações completas do buffer num único lote para o pool.
+    bool processar_quadros(Conexao& conexao) {
+        std::vector<char>& entrada = conexao.canal.get_entrada();
+        std::vector<EspecJogo> lote;
+        size_t lido = 0;
+        while (entrada.size() - lido >= sizeof(CabecalhoQuadro)) {
+            CabecalhoQuadro cabecalho;
+            std::memcpy(&cabecalho, entrada.data() + lido, sizeof(cabecalho));
+            if (cabecalho.tipo != static_cast<uint32_t>(TipoQuadro::LoteJogos) ||
+                cabecalho.quantidade > MAX_ITENS_QUADRO) {
+                return false;
+            }
+            size_t tamanho = sizeof(cabecalho) + cabecalho.quantidade * sizeof(EspecJogo);
+            if (entrada.size() - lido < tamanho) break;
+
+            size_t inicio = lote.size();
+            lote.resize(inicio + cabecalho.quantidade);
+            std::memcpy(lote.data() + inicio, entrada.data() + lido + sizeof(cabecalho),
+                        cabecalho.quantidade * sizeof(EspecJogo));
+            // Cada especificação vira alocação num worker: o cliente não escolhe o tamanho.
+            for (size_t i = inicio; i < lote.size(); ++i) {
+                if (lote[i].num_jogadores > MAX_JOGADORES_PARTIDA ||
+                    lote[i].tam_cronograma > sizeof(lote[i].cronograma)) {
+                    return false;
+                }
+            }
+            lido += tamanho;
+        }
+        conexao.canal.consumir(lido);
+
+        if (!lote.empty()) {
+            partidas_recebidas += lote.size();
+            std::weak_ptr<SaidaConexao> destino = conexao.saida;
+            if (cache) {
+                submeter_com_cache(std::move(lote), destino);
+            } else {
+                pool->submeter(std::move(lote), [this, destino](std::vector<ResultadoCompacto>&& resultados) {
+                    entregar(destino, std::move(resultados));
+                }, tamanho_bloco);
+            }
+        }
+        return true;
+    }
+
+    // Responde os acertos do cache na hora. As faltas vão para o pool com o
+    // índice no lote como id, para que a entrega ache a especificação a
+    // guardar e devolva o id original do cliente.
+    void submeter_com_cache(std::vector<EspecJogo> lote, const std::weak_ptr<SaidaConexao>& destino) {
+        std::vector<ResultadoCompacto> acertos;
+        auto faltas = std::make_shared<std::vector<EspecJogo>>();
+        for (const EspecJogo& espec : lote) {
+            ResultadoCompacto r;
+            if (cache->buscar(espec, r)) {
+                acertos.push_back(r);
+            } else {
+                faltas->push_back(espec);
+            }
+        }
+        if (!acertos.empty()) entregar(destino, std::move(acertos));
+        if (faltas->empty()) return;
+
+        std::vector<EspecJogo> para_pool = *faltas;
+        for (size_t i = 0; i < para_pool.size(); ++i) para_pool[i].id = static_cast<uint32_t>(i);
+        pool->submeter(std::move(para_pool), [this, destino, faltas](std::vector<ResultadoCompacto>&& resultados) {
+            for (ResultadoCompacto& r : resultados) {
+                const EspecJogo& espec = (*faltas)[r.id];
+                cache->guardar(espec, r);
+                r.id = espec.id;
+            }
+            entregar(destino, std::move(resultados));
+        }, tamanho_bloco);
+    }
+
+    // Chamado pelos workers.
+    void entregar(const std::weak_ptr<SaidaConexao>& destino, std::vector<ResultadoCompacto>&& resultados) {
+        auto saida = destino.lock();
+        if (!saida) return;
+        bool estava_vazia;
+        {
+            std::lock_guard<std::mutex> lock(saida->mutex);
+            estava_vazia = saida->prontos.empty();
+            saida->prontos.insert(saida->prontos.end(), resultados.begin(), resultados.end());
+        }
+        if (estava_vazia) {
+            {
+                std::lock_guard<std::mutex> lock(sujas_mutex);
+                sujas.push_back(saida);
+            }
+            uint64_t um = 1;
+            [[maybe_unused]] ssize_t n = ::write(aviso_fd, &um, sizeof(um));
+        }
+    }
+
+    void enviar_resultados() {
+        std::vector<std::shared_ptr<SaidaConexao>> pendentes;
+        {
+            std::lock_guard<std::mutex> lock(sujas_mutex);
+            pendentes.swap(sujas);
+        }
+        std::vector<ResultadoCompacto> resultados;
+        for (auto& saida : pendentes) {
+            auto it = conexoes.find(saida->fd);
+            if (it == conexoes.end() || it->second.saida != saida) continue;
+            {
+                std::lock_guard<std::mutex> lock(saida->mutex);
+                resultados.swap(saida->prontos);
+            }
+            CabecalhoQuadro cabecalho{static_cast<uint32_t>(TipoQuadro::LoteResultados),
+                                      static_cast<uint32_t>(resultados.size())};
+            Conexao& conexao = it->second;
+            conexao.canal.enfileirar_bytes(&cabecalho, sizeof(cabecalho));
+            conexao.canal.enfileirar_bytes(resultados.data(), resultados.size() * sizeof(ResultadoCompacto));
+            resultados.clear();
+            if (!conexao.canal.descarregar()) {
+                fechar(saida->fd);
+                continue;
+            }
+            atualizar_interesse(saida->fd, conexao);
+        }
+    }
+
+    void atualizar_interesse(int fd, Conexao& conexao) {
+        bool precisa = conexao.canal.tem_pendentes();
+        if (precisa == conexao.aguardando_escrita) return;
+        conexao.aguardando_escrita = precisa;
+        epoll_event ev{};
+        ev.events = EPOLLIN | (precisa ? EPOLLOUT : 0u);
+        ev.data.fd = fd;
+        ::epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &ev);
+    }
+
+    std::string caminho;
+    size_t tamanho_bloco;
+    int escuta_fd = -1;
+    int epoll_fd = -1;
+    int aviso_fd = -1;
+    std::atomic<bool> rodando{true};
+    uint64_t partidas_recebidas = 0;
+    std::unordered_map<int, Conexao> conexoes;
+    std::mutex sujas_mutex;
+    std::vector<std::shared_ptr<SaidaConexao>> sujas;
+    std::unique_ptr<CacheResultados> cache;
+    std::unique_ptr<PoolPartidas> pool;
+};
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "aleatorio.hpp"
+#include "jogo.hpp"
+#include "motor_eventos.hpp"
+
+/*
+ * Simulador em lote com uma partida por lane de vetor (8 lanes com AVX2,
+ * 16 com AVX-512), para estudos de Monte Carlo em que o custo de uma thread
+ * ou mesmo de um objeto por partida seria proibitivo.
+ *
+ * Segue o modelo do MotorEventos, mas sem fila de eventos. Com tempos de
+ * reação i.i.d., a rodada depende só de duas coisas:
+ * - quem tenta depois do prazo `espera_sentar_ms` (cada jogador ativo se
+ *   atrasa com probabilidade p = exp(-(prazo - mínimo) / média));
+ * - quem é o mais lento (uniforme entre os ativos).
+ * Se alguém se atrasou, os atrasados são os candidatos; senão, o candidato é
+ * o mais lento. A eliminação é uniforme entre os candidatos, feita pelo
+ * maior sorteio de 32 bits com operações mascaradas por lane. O conjunto de
+ * jogadores ativos de cada lane é uma máscara de bits, então n <= 32.
+ *
+ * Toda rodada elimina exatamente um jogador; todas as lanes terminam juntas
+ * após n - 1 rodadas.
+ */
+constexpr int MAX_JOGADORES_LANE = 32;
+constexpr int MAX_LANES = 16;
+
+struct ParametrosLote {
+    int num_jogadores;
+    uint32_t musica_min_ms;
+    uint32_t musica_faixa_ms;  // max - min + 1
+    uint32_t limiar_atraso;    // P(atraso) * 2^32
+};
+
+struct ResultadoBloco {
+    uint8_t vencedor[MAX_LANES];
+    uint8_t ordem[(MAX_JOGADORES_LANE - 1) * MAX_LANES];  // [rodada][lane], ids a partir de 0
+    uint32_t musica_ms[MAX_LANES];
+};
+
+template <int L>
+[[gnu::always_inline]] inline void simular_bloco_lanes(const ParametrosLote& p, uint64_t semente,
+                                                       ResultadoBloco& saida) {
+    using u32 = typename VetoresLanes<L>::u32;
+    using i32 = typename VetoresLanes<L>::i32;
+
+    Xoshiro128Lanes<L> rng;
+    rng.semear(semente);
+
+    const int n = p.num_jogadores;
+    u32 ativos = u32{} + (n == 32 ? 0xffffffffu : (1u << n) - 1);
+    u32 musica = u32{};
+
+    for (int r = 0; r < n - 1; ++r) {
+        musica += p.musica_min_ms + mulhi32<L>(rng.proximo(), p.musica_faixa_ms);
+
+        u32 chave_qualquer = u32{}, id_qualquer = u32{};
+        u32 chave_atrasado = u32{}, id_atrasado = u32{};
+        i32 houve_atraso = i32{};
+        for (int j = 0; j < n; ++j) {
+            // Máscara por aritmética: `!= 0` em vetores de 512 bits vira código escalar no GCC 12.
+            i32 ativo = -(i32)((ativos >> j) & 1u);
+            u32 chave = rng.proximo();
+
+            i32 melhor = ativo & (chave >= chave_qualquer);
+            chave_qualquer = melhor ? chave : chave_qualquer;
+            id_qualquer = melhor ? u32{} + j : id_qualquer;
+
+            if (p.limiar_atraso != 0) {
+                i32 atrasado = ativo & (rng.proximo() < p.limiar_atraso);
+                i32 melhor_atrasado = atrasado & (chave >= chave_atrasado);
+                chave_atrasado = melhor_atrasado ? chave : chave_atrasado;
+                id_atrasado = melhor_atrasado ? u32{} + j : id_atrasado;
+                houve_atraso |= atrasado;
+            }
+        }
+
+        u32 eliminado = houve_atraso ? id_atrasado : id_qualquer;
+        ativos &= ~((u32{} + 1u) << eliminado);  // 1 em todas as lanes, deslocado por lane
+        for (int l = 0; l < L; ++l) {
+            saida.ordem[r * L + l] = static_cast<uint8_t>(eliminado[l]);
+        }
+    }
+
+    for (int l = 0; l < L; ++l) {
+        saida.vencedor[l] = static_cast<uint8_t>(__builtin_ctz(ativos[l]));
+        saida.musica_ms[l] = musica[l];
+    }
+}
+
+__attribute__((target("avx512f,avx512vl,avx512bw,avx512dq")))
+inline void simular_bloco_avx512(const ParametrosLote& p, uint64_t semente, ResultadoBloco& saida) {
+    simular_bloco_lanes<16>(p, semente, saida);
+}
+
+__attribute__((target("avx2")))
+inline void simular_bloco_avx2(const ParametrosLote& p, uint64_t semente, ResultadoBloco& saida) {
+    simular_bloco_lanes<8>(p, semente, saida);
+}
+
+inline void simular_bloco_generico(const ParametrosLote& p, uint64_t semente, ResultadoBloco& saida) {
+    simular_bloco_lanes<8>(p, semente, saida);
+}
+
+struct EstatisticasLote {
+    uint64_t partidas = 0;
+    std::vector<uint64_t> vitorias;
+    std::vector<uint64_t> primeiro_eliminado;
+    uint64_t musica_total_ms = 0;
+};
+
+class SimuladorLotes {
+public:
+    // `largura` 0 escolhe a maior que a CPU suporta; 8 ou 16 forçam uma delas,
+    // e 16 sem AVX-512 é erro, não uma troca silenciosa por 8.
+    SimuladorLotes(const ConfigJogo& config, ModeloReacao reacao = {}, int largura = 0) {
+        if (config.num_jogadores < 2 || config.num_jogadores > MAX_JOGADORES_LANE) {
+            throw std::invalid_argument("o simulador em lote aceita de 2 a 32 jogadores");
+        }
+        if (!config.handicaps.empty() || !reacao.fatores.empty()) {
+            throw std::invalid_argument("o simulador em lote só modela jogadores idênticos");
+        }
+        parametros.num_jogadores = config.num_jogadores;
+        parametros.musica_min_ms = static_cast<uint32_t>(config.musica_min_ms);
+        parametros.musica_faixa_ms = static_cast<uint32_t>(config.musica_max_ms - config.musica_min_ms + 1);
+        double folga_us = config.espera_sentar_ms * 1000.0 - reacao.minimo_us;
+        double p_atraso = folga_us <= 0 ? 1.0 : std::exp(-folga_us / reacao.media_us);
+        parametros.limiar_atraso = static_cast<uint32_t>(std::min(p_atraso * 4294967296.0, 4294967295.0));
+
+        __builtin_cpu_init();
+        bool tem_avx512 = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+                          __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq");
+        bool tem_avx2 = __builtin_cpu_supports("avx2");
+        if (largura != 0 && largura != 8 && largura != 16) {
+            throw std::invalid_argument("--largura aceita 0 (automática), 8 ou 16");
+        }
+        if (largura == 16 && !tem_avx512) {
+            throw std::invalid_argument("--largura 16 precisa de AVX-512, que esta CPU não tem");
+        }
+        if ((largura == 0 || largura == 16) && tem_avx512) {
+            lanes = 16;
+            nucleo = simular_bloco_avx512;
+            isa = "AVX-512";
+        } else if (tem_avx2) {
+            lanes = 8;
+            nucleo = simular_bloco_avx2;
+            isa = "AVX2";
+        } else {
+            lanes = 8;
+            nucleo = simular_bloco_generico;
+            isa = "genérico";
+        }
+    }
+
+    EstatisticasLote executar(uint64_t jogos, uint64_t semente) const {
+        const int n = parametros.num_jogadores;
+        EstatisticasLote est;
+        est.vitorias.assign(n + 1, 0);
+        est.primeiro_eliminado.assign(n + 1, 0);
+
+        ResultadoBloco bloco;
+        SplitMix64 sementes(semente);
+        for (uint64_t feitos = 0; feitos < jogos; feitos += lanes) {
+            nucleo(parametros, sementes(), bloco);
+            int validas = static_cast<int>(std::min<uint64_t>(lanes, jogos - feitos));
+            for (int l = 0; l < validas; ++l) {
+                ++est.vitorias[bloco.vencedor[l] + 1];
+                ++est.primeiro_eliminado[bloco.ordem[l] + 1];
+                est.musica_total_ms += bloco.musica_ms[l];
+            }
+            est.partidas += validas;
+        }
+        return est;
+    }
+
+    int get_lanes() const { return lanes; }
+    const char* get_isa() const { return isa; }
+
+private:
+    ParametrosLote parametros;
+    int lanes = 8;
+    void (*nucleo)(const ParametrosLote&, uint64_t, ResultadoBloco&) = simular_bloco_generico;
+    const char* isa = "genérico";
+};
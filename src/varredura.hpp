@@ -0,0 +1,209 @@
+#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "cache_resultados.hpp"
+#include "partida.hpp"
+#include "pool_partidas.hpp"
+
+/*
+ * Varredura de Monte Carlo sobre o motor em pool: uma grade de número de
+ * jogadores × cronograma de remoção × modo de espera, com lotes de partidas
+ * semeadas por célula. Cada célula para assim que os intervalos de confiança
+ * das métricas-alvo ficam estreitos o bastante, em vez de rodar um número
+ * fixo de partidas:
+ *
+ * - taxa de vitória por assento: meia-largura do intervalo normal de cada
+ *   P(vitória de Pi) abaixo de `meia_largura_vitoria`;
+ * - custo por rodada (tempo de worker por rodada, que no modo de condição é a
+ *   latência da rodada): médias por lote, meia-largura relativa abaixo de
+ *   `erro_relativo_custo`.
+ *
+ * Com um CacheResultados, partidas já jogadas (mesma especificação e semente,
+ * em outra execução ou célula) vêm do cache e só as novas vão para o pool. O
+ * custo por rodada é medido só sobre as rodadas que o pool executou.
+ */
+struct CelulaVarredura {
+    int num_jogadores = 4;
+    std::string cronograma = "1";
+    ModoEspera modo = ModoEspera::CondicaoMusica;
+};
+
+struct CriterioParada {
+    double meia_largura_vitoria = 0.01;
+    double erro_relativo_custo = 0.05;
+    double z = 1.96;                      // quantil normal do nível de confiança
+    int lotes_minimos = 8;
+    uint32_t tamanho_lote = 2000;
+    uint64_t partidas_maximas = 2'000'000;
+};
+
+struct ResultadoCelula {
+    CelulaVarredura celula;
+    uint64_t partidas = 0;
+    uint64_t do_cache = 0;            // partidas respondidas pelo CacheResultados
+    int lotes = 0;
+    double desvio_vitoria = 0;        // max |P(vitória de Pi) - 1/n|
+    double meia_largura_vitoria = 0;  // maior entre os assentos
+    double custo_rodada_us = 0;
+    double meia_largura_custo_us = 0;
+    bool convergiu = false;
+    double segundos = 0;
+};
+
+inline const char* nome_modo(ModoEspera modo) {
+    return modo == ModoEspera::EventFd ? "eventfd" : "condicao";
+}
+
+class Varredura {
+public:
+    Varredura(int workers, uint32_t musica_us, CriterioParada criterio, uint64_t semente)
+        : workers(workers), musica_us(musica_us), criterio(criterio), semente(semente) {}
+
+    void usar_cache(CacheResultados* novo) { cache = novo; }
+
+    ResultadoCelula executar(const CelulaVarredura& celula) {
+        ResultadoCelula r;
+        r.celula = celula;
+        PoolPartidas pool(workers, celula.modo);
+        const double workers_ativos = static_cast<double>(pool.get_num_workers());
+
+        EspecJogo modelo;
+        modelo.num_jogadores = static_cast<uint32_t>(celula.num_jogadores);
+        modelo.musica_us = musica_us;
+        ler_cronograma(celula.cronograma, modelo);
+
+        std::vector<uint64_t> vitorias(celula.num_jogadores + 1, 0);
+        double soma_custo = 0, soma_quadrados = 0;
+        int amostras_custo = 0;
+        auto inicio = std::chrono::steady_clock::now();
+
+        while (r.partidas < criterio.partidas_maximas) {
+            std::vector<EspecJogo> lote(criterio.tamanho_lote, modelo);
+            for (uint32_t i = 0; i < criterio.tamanho_lote; ++i) {
+                lote[i].id = i;
+                lote[i].semente = semente + r.partidas + i;
+            }
+
+            if (cache) {
+                size_t antes = lote.size();
+                consultar_cache(lote, vitorias);
+                r.do_cache += antes - lote.size();
+            }
+
+            // Só o que foi ao pool entra no custo; um lote inteiro do cache não é amostra.
+            if (!lote.empty()) {
+                uint64_t rodadas = 0;
+                auto inicio_lote = std::chrono::steady_clock::now();
+                executar_lote(pool, std::move(lote), vitorias, rodadas);
+                double segundos_lote =
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio_lote).count();
+
+                double custo = segundos_lote * 1e6 * workers_ativos / std::max<uint64_t>(1, rodadas);
+                soma_custo += custo;
+                soma_quadrados += custo * custo;
+                ++amostras_custo;
+            }
+            r.partidas += criterio.tamanho_lote;
+            ++r.lotes;
+
+            avaliar(r, vitorias, soma_custo, soma_quadrados, amostras_custo);
+            if (r.lotes >= criterio.lotes_minimos && r.convergiu) break;
+        }
+
+        r.segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        return r;
+    }
+
+    static void escrever_cabecalho_csv(std::ostream& saida) {
+        saida << "jogadores,cronograma,espera,partidas,lotes,desvio_vitoria,meia_largura_vitoria,"
+                 "custo_rodada_us,meia_largura_custo_us,convergiu,segundos\n";
+    }
+
+    static void escrever_csv(std::ostream& saida, const ResultadoCelula& r) {
+        saida << r.celula.num_jogadores << ",\"" << r.celula.cronograma << "\"," << nome_modo(r.celula.modo) << ","
+              << r.partidas << "," << r.lotes << "," << r.desvio_vitoria << "," << r.meia_largura_vitoria << ","
+              << r.custo_rodada_us << "," << r.meia_largura_custo_us << "," << (r.convergiu ? 1 : 0) << ","
+              << r.segundos << "\n";
+    }
+
+private:
+    // Conta as partidas que o cache já conhece e as tira do lote.
+    void consultar_cache(std::vector<EspecJogo>& lote, std::vector<uint64_t>& vitorias) {
+        size_t restantes = 0;
+        for (const EspecJogo& espec : lote) {
+            ResultadoCompacto resultado;
+            if (cache->buscar(espec, resultado)) {
+                if (resultado.vencedor < vitorias.size()) ++vitorias[resultado.vencedor];
+            } else {
+                lote[restantes++] = espec;
+            }
+        }
+        lote.resize(restantes);
+    }
+
+    // Submete o lote e espera todos os resultados.
+    void executar_lote(PoolPartidas& pool, std::vector<EspecJogo> lote, std::vector<uint64_t>& vitorias,
+                       uint64_t& rodadas) {
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t faltam = lote.size();
+        // O id é o índice no lote: a entrega acha a especificação a guardar no cache.
+        std::vector<EspecJogo> especs;
+        if (cache) {
+            for (uint32_t i = 0; i < lote.size(); ++i) lote[i].id = i;
+            especs = lote;
+        }
+        pool.submeter(std::move(lote), [&](std::vector<ResultadoCompacto>&& resultados) {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (const ResultadoCompacto& resultado : resultados) {
+                if (resultado.vencedor < vitorias.size()) ++vitorias[resultado.vencedor];
+                rodadas += resultado.rodadas;
+                if (cache) cache->guardar(especs[resultado.id], resultado);
+            }
+            faltam -= resultados.size();
+            if (faltam == 0) cv.notify_one();
+        });
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&] { return faltam == 0; });
+    }
+
+    void avaliar(ResultadoCelula& r, const std::vector<uint64_t>& vitorias, double soma_custo,
+                 double soma_quadrados, int amostras_custo) const {
+        const double n = static_cast<double>(r.partidas);
+        const double esperado = 1.0 / r.celula.num_jogadores;
+        r.desvio_vitoria = 0;
+        r.meia_largura_vitoria = 0;
+        for (int id = 1; id <= r.celula.num_jogadores; ++id) {
+            double p = vitorias[id] / n;
+            r.desvio_vitoria = std::max(r.desvio_vitoria, std::fabs(p - esperado));
+            // Com p perto de 0 o intervalo normal encolhe demais; usa o pior caso entre p e 1/n.
+            double q = std::max(p, esperado);
+            r.meia_largura_vitoria = std::max(r.meia_largura_vitoria, criterio.z * std::sqrt(q * (1 - q) / n));
+        }
+
+        // Sem amostras (tudo veio do cache) não há custo a estimar.
+        const double lotes = std::max(1, amostras_custo);
+        r.custo_rodada_us = soma_custo / lotes;
+        double variancia = lotes > 1 ? std::max(0.0, (soma_quadrados - lotes * r.custo_rodada_us * r.custo_rodada_us) /
+                                                         (lotes - 1))
+                                     : 0.0;
+        r.meia_largura_custo_us = criterio.z * std::sqrt(variancia / lotes);
+
+        r.convergiu = r.meia_largura_vitoria <= criterio.meia_largura_vitoria &&
+                      r.meia_largura_custo_us <= criterio.erro_relativo_custo * r.custo_rodada_us;
+    }
+
+    int workers;
+    uint32_t musica_us;
+    CriterioParada criterio;
+    uint64_t semente;
+    CacheResultados* cache = nullptr;
+};